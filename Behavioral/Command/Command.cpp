@@ -78,8 +78,8 @@ class Invoker {
      * @var Command
      */
 private:
-    Command *on_start_;
-    Command *on_finish_;
+    Command *on_start_ = nullptr;
+    Command *on_finish_ = nullptr;
     /**
      * Initialize commands.
      */
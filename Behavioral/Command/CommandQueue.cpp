@@ -0,0 +1,551 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Command execution subsystem.
+ *
+ * Commands are stored by value in InlineCommand, a type-erased wrapper with a
+ * small inline buffer, so a typical command needs no allocation of its own.
+ * A CommandExecutor owns a bounded lock-free MPMC queue of such commands and
+ * a few worker threads that drain it in batches. It keeps counters for
+ * throughput and queue depth.
+ */
+
+/**
+ * The Command interface declares a method for executing a command.
+ */
+class Command {
+public:
+    virtual ~Command() {}
+    virtual void Execute() const = 0;
+};
+
+/**
+ * Some commands can implement simple operations on their own. The payload is
+ * moved in rather than copied.
+ */
+class SimpleCommand : public Command {
+private:
+    std::string pay_load_;
+public:
+    explicit SimpleCommand(std::string pay_load) : pay_load_(std::move(pay_load)) {}
+    void Execute() const override {
+        std::cout << "SimpleCommand: See, I can do simple things like printing (" << this->pay_load_ << ")\n";
+    }
+};
+
+/**
+ * The Receiver classes contain some important business logic. They know how to
+ * perform all kinds of operations, associated with carrying out a request. In
+ * fact, any class may serve as a Receiver.
+ */
+class Reciever {
+public:
+    void DoSomething(const std::string &a) {
+        std::cout << "Receiver: Working on (" << a << ".)\n";
+    }
+    void DoSomethingElse(const std::string &b) {
+        std::cout << "Receiver: Also working on (" << b << ".)\n";
+    }
+};
+
+/**
+ * However, some commands can delegate more complex operations to other objects,
+ * called "receivers."
+ */
+class ComplexCommand : public Command {
+private:
+    Reciever *reciever_;
+    /**
+     * Context data, required for launching the receiver's methods.
+     */
+    std::string a_;
+    std::string b_;
+public:
+    ComplexCommand(Reciever *reciever, std::string a, std::string b) : reciever_(reciever), a_(std::move(a)), b_(std::move(b)) {}
+    void Execute() const override {
+        std::cout << "ComplexCommand: Complex stuff should be done by a receiver object.\n";
+        this->reciever_->DoSomething(this->a_);
+        this->reciever_->DoSomethingElse(this->b_);
+    }
+};
+
+/**
+ * Holds any object with a `void Execute() const` method by value. Objects up
+ * to kInlineSize bytes that can be moved without throwing live in the inline
+ * buffer; anything else is moved to the heap. ComplexCommand fits inline.
+ */
+class InlineCommand {
+public:
+    static constexpr size_t kInlineSize = 88;
+
+    InlineCommand() noexcept {}
+
+    template <typename C, typename = std::enable_if_t<!std::is_same<std::decay_t<C>, InlineCommand>::value>>
+    InlineCommand(C &&command) {
+        using T = std::decay_t<C>;
+        if constexpr (sizeof(T) <= kInlineSize && alignof(T) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible<T>::value) {
+            new (this->storage_) T(std::forward<C>(command));
+            this->ops_ = &InlineModel<T>::kOps;
+        } else {
+            *reinterpret_cast<T **>(this->storage_) = new T(std::forward<C>(command));
+            this->ops_ = &HeapModel<T>::kOps;
+        }
+    }
+
+    InlineCommand(InlineCommand &&other) noexcept {
+        this->MoveFrom(other);
+    }
+    InlineCommand &operator=(InlineCommand &&other) noexcept {
+        if (this != &other) {
+            this->Reset();
+            this->MoveFrom(other);
+        }
+        return *this;
+    }
+    InlineCommand(const InlineCommand &) = delete;
+    InlineCommand &operator=(const InlineCommand &) = delete;
+    ~InlineCommand() {
+        this->Reset();
+    }
+
+    void Execute() const {
+        this->ops_->execute_(this->storage_);
+    }
+    explicit operator bool() const {
+        return this->ops_ != nullptr;
+    }
+    bool is_inline() const {
+        return this->ops_ != nullptr && this->ops_->inline_;
+    }
+
+    void Reset() {
+        if (this->ops_ != nullptr) {
+            this->ops_->destroy_(this->storage_);
+            this->ops_ = nullptr;
+        }
+    }
+
+private:
+    struct Ops {
+        void (*execute_)(const void *);
+        void (*move_)(void *from, void *to) noexcept;
+        void (*destroy_)(void *) noexcept;
+        bool inline_;
+    };
+
+    template <typename T>
+    struct InlineModel {
+        static void Execute(const void *p) {
+            static_cast<const T *>(p)->Execute();
+        }
+        static void Move(void *from, void *to) noexcept {
+            new (to) T(std::move(*static_cast<T *>(from)));
+            static_cast<T *>(from)->~T();
+        }
+        static void Destroy(void *p) noexcept {
+            static_cast<T *>(p)->~T();
+        }
+        static constexpr Ops kOps = {&Execute, &Move, &Destroy, true};
+    };
+
+    template <typename T>
+    struct HeapModel {
+        static void Execute(const void *p) {
+            (*static_cast<T *const *>(p))->Execute();
+        }
+        static void Move(void *from, void *to) noexcept {
+            *static_cast<T **>(to) = *static_cast<T **>(from);
+        }
+        static void Destroy(void *p) noexcept {
+            delete *static_cast<T **>(p);
+        }
+        static constexpr Ops kOps = {&Execute, &Move, &Destroy, false};
+    };
+
+    void MoveFrom(InlineCommand &other) noexcept {
+        if (other.ops_ != nullptr) {
+            other.ops_->move_(other.storage_, this->storage_);
+            this->ops_ = other.ops_;
+            other.ops_ = nullptr;
+        }
+    }
+
+    const Ops *ops_ = nullptr;
+    alignas(std::max_align_t) unsigned char storage_[kInlineSize];
+};
+
+/**
+ * A bounded multi-producer, multi-consumer queue (Dmitry Vyukov's design).
+ * Every cell carries a sequence number that tells producers and consumers
+ * whose turn it is. Claiming a cell is a single CAS on the head or tail, and
+ * there are no locks anywhere. Capacity is rounded up to a power of two.
+ */
+class CommandQueue {
+public:
+    explicit CommandQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size *= 2;
+        }
+        this->mask_ = size - 1;
+        this->cells_.reset(new Cell[size]);
+        for (size_t i = 0; i < size; ++i) {
+            this->cells_[i].sequence_.store(i, std::memory_order_relaxed);
+        }
+    }
+    ~CommandQueue() {
+        InlineCommand command;
+        while (this->TryPop(command)) {
+        }
+    }
+    CommandQueue(const CommandQueue &) = delete;
+    CommandQueue &operator=(const CommandQueue &) = delete;
+
+    /**
+     * Moves `command` into the queue. Returns false, leaving `command` alone,
+     * if the queue is full.
+     */
+    bool TryPush(InlineCommand &command) {
+        size_t position = this->tail_.load(std::memory_order_relaxed);
+        Cell *cell;
+        for (;;) {
+            cell = &this->cells_[position & this->mask_];
+            size_t sequence = cell->sequence_.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                if (this->tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = this->tail_.load(std::memory_order_relaxed);
+            }
+        }
+        new (cell->storage_) InlineCommand(std::move(command));
+        cell->sequence_.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Moves the oldest command into `out`. Returns false if the queue is empty.
+     */
+    bool TryPop(InlineCommand &out) {
+        size_t position = this->head_.load(std::memory_order_relaxed);
+        Cell *cell;
+        for (;;) {
+            cell = &this->cells_[position & this->mask_];
+            size_t sequence = cell->sequence_.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+            if (difference == 0) {
+                if (this->head_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = this->head_.load(std::memory_order_relaxed);
+            }
+        }
+        InlineCommand *stored = std::launder(reinterpret_cast<InlineCommand *>(cell->storage_));
+        out = std::move(*stored);
+        stored->~InlineCommand();
+        cell->sequence_.store(position + this->mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Commands waiting right now; only a snapshot while other threads run.
+     */
+    size_t depth() const {
+        size_t tail = this->tail_.load(std::memory_order_relaxed);
+        size_t head = this->head_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    size_t capacity() const {
+        return this->mask_ + 1;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence_;
+        alignas(InlineCommand) unsigned char storage_[sizeof(InlineCommand)];
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> tail_{0};
+    alignas(64) std::atomic<size_t> head_{0};
+};
+
+struct ExecutorStats {
+    size_t submitted_ = 0;
+    size_t executed_ = 0;
+    size_t batches_ = 0;
+    /**
+     * Times Submit() found the queue full and had to wait.
+     */
+    size_t full_waits_ = 0;
+    size_t max_depth_ = 0;
+    /**
+     * Queue depth seen by Submit(), averaged over all submissions.
+     */
+    double average_depth_ = 0;
+};
+
+/**
+ * Worker threads draining a CommandQueue. Each worker pops up to
+ * `batch_size` commands, runs them, and only then touches the shared
+ * counters, once per batch. A worker that finds the queue empty
+ * `kIdleSpins` times in a row parks on a condition variable until a
+ * submission wakes it. There is always at least one worker.
+ */
+class CommandExecutor {
+public:
+    static constexpr size_t kIdleSpins = 64;
+
+    CommandExecutor(size_t workers, size_t capacity = 4096, size_t batch_size = 32)
+        : queue_(capacity), batch_size_(batch_size == 0 ? 1 : batch_size) {
+        for (size_t i = 0; i < (workers == 0 ? 1 : workers); ++i) {
+            this->workers_.emplace_back([this] { this->WorkerLoop(); });
+        }
+    }
+    /**
+     * Runs whatever is still queued, then stops the workers.
+     */
+    ~CommandExecutor() {
+        this->WaitIdle();
+        this->stopping_.store(true, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(this->idle_mutex_);
+        }
+        this->idle_.notify_all();
+        for (std::thread &worker : this->workers_) {
+            worker.join();
+        }
+    }
+
+    bool TrySubmit(InlineCommand &command) {
+        size_t depth = this->queue_.depth();
+        if (!this->queue_.TryPush(command)) {
+            return false;
+        }
+        this->submitted_.fetch_add(1, std::memory_order_relaxed);
+        this->depth_sum_.fetch_add(depth, std::memory_order_relaxed);
+        size_t max = this->max_depth_.load(std::memory_order_relaxed);
+        while (depth > max && !this->max_depth_.compare_exchange_weak(max, depth, std::memory_order_relaxed)) {
+        }
+        // Pairs with the fence in Park(): either the parking worker sees this
+        // command or this sees the worker
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (this->parked_.load(std::memory_order_relaxed) != 0) {
+            {
+                std::lock_guard<std::mutex> lock(this->idle_mutex_);
+            }
+            this->idle_.notify_one();
+        }
+        return true;
+    }
+
+    /**
+     * Like TrySubmit, but waits for room when the queue is full.
+     */
+    void Submit(InlineCommand command) {
+        while (!this->TrySubmit(command)) {
+            this->full_waits_.fetch_add(1, std::memory_order_relaxed);
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     * Returns once every command submitted so far has run.
+     */
+    void WaitIdle() const {
+        while (this->executed_.load(std::memory_order_acquire) != this->submitted_.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+
+    ExecutorStats Stats() const {
+        ExecutorStats stats;
+        stats.submitted_ = this->submitted_.load();
+        stats.executed_ = this->executed_.load();
+        stats.batches_ = this->batches_.load();
+        stats.full_waits_ = this->full_waits_.load();
+        stats.max_depth_ = this->max_depth_.load();
+        stats.average_depth_ = stats.submitted_ ? static_cast<double>(this->depth_sum_.load()) / stats.submitted_ : 0;
+        return stats;
+    }
+
+private:
+    /**
+     * Sleeps until the queue has something in it or the executor stops.
+     */
+    void Park() {
+        std::unique_lock<std::mutex> lock(this->idle_mutex_);
+        this->parked_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        this->idle_.wait(lock, [this] {
+            return this->queue_.depth() != 0 || this->stopping_.load(std::memory_order_acquire);
+        });
+        this->parked_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void WorkerLoop() {
+        std::vector<InlineCommand> batch(this->batch_size_);
+        size_t idle = 0;
+        while (!this->stopping_.load(std::memory_order_acquire)) {
+            size_t count = 0;
+            while (count < this->batch_size_ && this->queue_.TryPop(batch[count])) {
+                ++count;
+            }
+            if (count == 0) {
+                if (++idle < kIdleSpins) {
+                    std::this_thread::yield();
+                } else {
+                    this->Park();
+                    idle = 0;
+                }
+                continue;
+            }
+            idle = 0;
+            for (size_t i = 0; i < count; ++i) {
+                batch[i].Execute();
+                batch[i].Reset();
+            }
+            this->batches_.fetch_add(1, std::memory_order_relaxed);
+            this->executed_.fetch_add(count, std::memory_order_release);
+        }
+    }
+
+    CommandQueue queue_;
+    size_t batch_size_;
+    std::vector<std::thread> workers_;
+    std::atomic<bool> stopping_{false};
+    std::mutex idle_mutex_;
+    std::condition_variable idle_;
+    std::atomic<size_t> parked_{0};
+    std::atomic<size_t> submitted_{0};
+    std::atomic<size_t> executed_{0};
+    std::atomic<size_t> batches_{0};
+    std::atomic<size_t> full_waits_{0};
+    std::atomic<size_t> max_depth_{0};
+    std::atomic<size_t> depth_sum_{0};
+};
+
+/**
+ * The Invoker is associated with one or several commands. It sends a request to
+ * the command. The commands are held by value, usually without touching the
+ * heap.
+ */
+class Invoker {
+private:
+    InlineCommand on_start_;
+    InlineCommand on_finish_;
+public:
+    void SetOnStart(InlineCommand command) {
+        this->on_start_ = std::move(command);
+    }
+    void SetOnFinish(InlineCommand command) {
+        this->on_finish_ = std::move(command);
+    }
+    void DoSomethingImportant() {
+        std::cout << "Invoker: Does anybody want something done before I begin?\n";
+        if (this->on_start_) {
+            this->on_start_.Execute();
+        }
+        std::cout << "Invoker: ...doing something really important...\n";
+        std::cout << "Invoker: Does anybody want something done after I finish?\n";
+        if (this->on_finish_) {
+            this->on_finish_.Execute();
+        }
+    }
+};
+
+/**
+ * A quiet receiver for the benchmark: it only tallies its work.
+ */
+class TallyReciever {
+public:
+    std::atomic<size_t> work_{0};
+    void DoSomething(const std::string &a) {
+        this->work_.fetch_add(a.size(), std::memory_order_relaxed);
+    }
+    void DoSomethingElse(const std::string &b) {
+        this->work_.fetch_add(b.size(), std::memory_order_relaxed);
+    }
+};
+
+class TallyCommand : public Command {
+private:
+    TallyReciever *reciever_;
+    std::string a_;
+    std::string b_;
+public:
+    TallyCommand(TallyReciever *reciever, std::string a, std::string b) : reciever_(reciever), a_(std::move(a)), b_(std::move(b)) {}
+    void Execute() const override {
+        this->reciever_->DoSomething(this->a_);
+        this->reciever_->DoSomethingElse(this->b_);
+    }
+};
+
+static_assert(sizeof(ComplexCommand) <= InlineCommand::kInlineSize, "typical commands are stored inline");
+
+/**
+ * The client code can parameterize an invoker with any commands.
+ */
+int main() {
+    Reciever reciever;
+    Invoker invoker;
+    invoker.SetOnStart(SimpleCommand("Say Hi!"));
+    invoker.SetOnFinish(ComplexCommand(&reciever, "Send email", "Save report"));
+    invoker.DoSomethingImportant();
+
+    const size_t commands = 1000000;
+    const size_t workers = std::max(1u, std::thread::hardware_concurrency());
+    TallyReciever tally;
+
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < commands; ++i) {
+        Command *command = new TallyCommand(&tally, "Send email", "Save report");
+        command->Execute();
+        delete command;
+    }
+    double inline_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    ExecutorStats stats;
+    double queued_seconds;
+    {
+        CommandExecutor executor(workers, 4096, 32);
+        begin = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < commands; ++i) {
+            executor.Submit(TallyCommand(&tally, "Send email", "Save report"));
+        }
+        executor.WaitIdle();
+        queued_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        stats = executor.Stats();
+    }
+
+    std::cout << "\nExecuting " << commands << " commands:\n"
+              << "  new + Execute + delete on the caller: " << commands / inline_seconds / 1e6 << " M commands/s\n"
+              << "  CommandExecutor, " << workers << " worker(s):       " << commands / queued_seconds / 1e6 << " M commands/s\n"
+              << "  " << stats.executed_ << " executed in " << stats.batches_ << " batches ("
+              << static_cast<double>(stats.executed_) / stats.batches_ << " per batch), queue depth avg "
+              << stats.average_depth_ << " / max " << stats.max_depth_ << ", " << stats.full_waits_ << " waits on a full queue\n"
+              << "  receiver tally: " << tally.work_ << "\n";
+    return 0;
+}
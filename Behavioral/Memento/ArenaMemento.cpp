@@ -0,0 +1,299 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <new>
+
+/**
+ * Arena-backed Memento.
+ *
+ * Backup() is on the hot path here, so a memento is a single block carved out
+ * of a monotonic arena owned by the Caretaker: a small header followed by the
+ * state bytes. Saving costs one bump allocation and one memcpy. The creation
+ * time is kept as a raw 64-bit steady-clock value and is only turned into a
+ * human-readable date when a name is actually displayed.
+ */
+
+/**
+ * A monotonic arena: allocations bump a pointer inside the current chunk and
+ * are only released all at once. Because the Caretaker undoes in LIFO order,
+ * the most recent allocation can also be handed back with Rewind().
+ */
+class MonotonicArena {
+public:
+    explicit MonotonicArena(size_t chunk_size = 64 * 1024) : chunk_size_(chunk_size) {}
+
+    MonotonicArena(const MonotonicArena &) = delete;
+    void operator=(const MonotonicArena &) = delete;
+
+    void *Allocate(size_t size, size_t alignment) {
+        size_t offset = (this->used_ + alignment - 1) & ~(alignment - 1);
+        if (this->chunks_.empty() || offset + size > this->capacity_) {
+            this->capacity_ = std::max(this->chunk_size_, size + alignment);
+            this->chunks_.emplace_back(new std::byte[this->capacity_]);
+            // new[] returns storage aligned for any fundamental type.
+            offset = 0;
+        }
+        void *p = this->chunks_.back().get() + offset;
+        this->used_ = offset + size;
+        return p;
+    }
+
+    /**
+     * Gives back `p` and everything allocated after it, as long as it lives in
+     * the current chunk; otherwise its space stays reserved until the arena
+     * dies.
+     */
+    void Rewind(void *p) {
+        std::byte *base = this->chunks_.empty() ? nullptr : this->chunks_.back().get();
+        std::byte *at = static_cast<std::byte *>(p);
+        if (base != nullptr && at >= base && at < base + this->used_) {
+            this->used_ = static_cast<size_t>(at - base);
+        }
+    }
+
+    size_t chunks() const {
+        return this->chunks_.size();
+    }
+
+private:
+    size_t chunk_size_;
+    size_t capacity_ = 0;
+    size_t used_ = 0;
+    std::vector<std::unique_ptr<std::byte[]>> chunks_;
+};
+
+/**
+ * The Memento interface provides a way to retrieve the memento's metadata, such
+ * as creation date or name. However, it doesn't expose the Originator's state.
+ */
+class Memento {
+public:
+    virtual std::string GetName() const = 0;
+    virtual std::string date() const = 0;
+    virtual std::string_view state() const = 0;
+};
+
+/**
+ * The Concrete Memento contains the infrastructure for storing the Originator's
+ * state. The state bytes follow the object directly in the same arena block.
+ */
+class ConcreteMemento : public Memento {
+private:
+    uint64_t timestamp_;
+    uint32_t size_;
+
+    ConcreteMemento(uint64_t timestamp, uint32_t size) : timestamp_(timestamp), size_(size) {}
+
+    const char *data() const {
+        return reinterpret_cast<const char *>(this + 1);
+    }
+
+    /**
+     * Maps a steady-clock reading to wall-clock time using one reference pair
+     * taken the first time a date is formatted.
+     */
+    static std::time_t ToWallClock(uint64_t timestamp) {
+        static const auto steady_ref = std::chrono::steady_clock::now();
+        static const auto system_ref = std::chrono::system_clock::now();
+        auto since = std::chrono::steady_clock::duration(timestamp) - steady_ref.time_since_epoch();
+        return std::chrono::system_clock::to_time_t(system_ref + std::chrono::duration_cast<std::chrono::system_clock::duration>(since));
+    }
+
+public:
+    /**
+     * Builds a memento of `state` inside `arena`.
+     */
+    static ConcreteMemento *Create(MonotonicArena &arena, std::string_view state) {
+        void *block = arena.Allocate(sizeof(ConcreteMemento) + state.size(), alignof(ConcreteMemento));
+        ConcreteMemento *memento = new (block) ConcreteMemento(std::chrono::steady_clock::now().time_since_epoch().count(), static_cast<uint32_t>(state.size()));
+        std::memcpy(static_cast<std::byte *>(block) + sizeof(ConcreteMemento), state.data(), state.size());
+        return memento;
+    }
+
+    /**
+     * The Originator uses this method when restoring its state.
+     */
+    std::string_view state() const override {
+        return std::string_view(this->data(), this->size_);
+    }
+    /**
+     * The rest of the methods are used by the Caretaker to display metadata.
+     * Nothing is formatted until one of them is called.
+     */
+    std::string GetName() const override {
+        return this->date() + " / (" + std::string(this->state().substr(0, 9)) + "...)";
+    }
+    std::string date() const override {
+        std::time_t when = ToWallClock(this->timestamp_);
+        char buffer[32];
+        std::strftime(buffer, sizeof(buffer), "%a %b %e %H:%M:%S %Y", std::localtime(&when));
+        return buffer;
+    }
+    uint64_t timestamp() const {
+        return this->timestamp_;
+    }
+};
+
+/**
+ * The Originator holds some important state that may change over time. It also
+ * defines a method for saving the state inside a memento and another method for
+ * restoring the state from it.
+ */
+class Originator {
+    /**
+     * @var string For the sake of simplicity, the originator's state is stored
+     * inside a single variable.
+     */
+private:
+    std::string state_;
+
+    std::string GenerateRandomString(int length = 10) {
+        const char alphanum[] =
+            "0123456789"
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+            "abcdefghijklmnopqrstuvwxyz";
+        int stringLength = sizeof(alphanum) - 1;
+
+        std::string random_string;
+        for (int i = 0; i < length; i++) {
+            random_string += alphanum[std::rand() % stringLength];
+        }
+        return random_string;
+    }
+
+public:
+    Originator(std::string state) : state_(state) {
+        std::cout << "Originator: My initial state is: " << this->state_ << "\n";
+    }
+    /**
+     * The Originator's business logic may affect its internal state. Therefore,
+     * the client should backup the state before launching methods of the business
+     * logic via the save() method.
+     */
+    void DoSomething() {
+        this->state_ = this->GenerateRandomString(30);
+    }
+
+    /**
+     * Saves the current state inside a memento allocated from the caretaker's
+     * arena.
+     */
+    Memento *Save(MonotonicArena &arena) {
+        return ConcreteMemento::Create(arena, this->state_);
+    }
+
+    /**
+     * Restores the Originator's state from a memento object.
+     */
+    void Restore(const Memento *memento) {
+        this->state_ = memento->state();
+        std::cout << "Originator: My state has changed to: " << this->state_ << "\n";
+    }
+};
+
+/**
+ * The Caretaker doesn't depend on the Concrete Memento class. Therefore, it
+ * doesn't have access to the originator's state, stored inside the memento. It
+ * works with all mementos via the base Memento interface. It owns the arena
+ * the mementos live in, so they are released together with it.
+ */
+class Caretaker {
+private:
+    MonotonicArena arena_;
+    std::vector<Memento *> mementos_;
+    Originator *originator_;
+
+public:
+    Caretaker(Originator *originator, size_t expected_backups = 0) : originator_(originator) {
+        this->mementos_.reserve(expected_backups);
+    }
+
+    void Backup() {
+        this->mementos_.push_back(this->originator_->Save(this->arena_));
+    }
+
+    void Undo() {
+        if (!this->mementos_.size()) {
+            return;
+        }
+        Memento *memento = this->mementos_.back();
+        this->mementos_.pop_back();
+        std::cout << "Caretaker: Restoring state to: " << memento->GetName() << "\n";
+        this->originator_->Restore(memento);
+        this->arena_.Rewind(memento);
+    }
+
+    void ShowHistory() const {
+        std::cout << "Caretaker: Here's the list of mementos:\n";
+        for (Memento *memento : this->mementos_) {
+            std::cout << memento->GetName() << "\n";
+        }
+    }
+
+    size_t size() const {
+        return this->mementos_.size();
+    }
+
+    size_t chunks() const {
+        return this->arena_.chunks();
+    }
+};
+
+/**
+ * Client code.
+ */
+
+void ClientCode() {
+    Originator *originator = new Originator("Super-duper-super-puper-super.");
+    Caretaker *caretaker = new Caretaker(originator);
+    std::cout << "\nCaretaker: Saving Originator's state...\n";
+    caretaker->Backup();
+    originator->DoSomething();
+    std::cout << "Caretaker: Saving Originator's state...\n";
+    caretaker->Backup();
+    originator->DoSomething();
+    std::cout << "Caretaker: Saving Originator's state...\n";
+    caretaker->Backup();
+    originator->DoSomething();
+    std::cout << "\n";
+    caretaker->ShowHistory();
+    std::cout << "\nClient: Now, let's rollback!\n\n";
+    caretaker->Undo();
+    std::cout << "\nClient: Once more!\n\n";
+    caretaker->Undo();
+
+    delete originator;
+    delete caretaker;
+}
+
+/**
+ * Backup() in a tight loop: no per-memento heap allocation and no date
+ * formatting.
+ */
+void BackupBenchmark() {
+    const size_t backups = 1000000;
+    Originator originator("Super-duper-super-puper-super.");
+    Caretaker caretaker(&originator, backups);
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < backups; ++i) {
+        caretaker.Backup();
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin);
+    std::cout << "\nCaretaker: " << caretaker.size() << " backups in " << caretaker.chunks() << " arena chunks, "
+              << elapsed.count() / backups << " ns per Backup()\n";
+}
+
+int main() {
+    std::srand(static_cast<unsigned int>(std::time(NULL)));
+    ClientCode();
+    BackupBenchmark();
+    return 0;
+}
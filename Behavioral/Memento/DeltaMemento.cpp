@@ -0,0 +1,363 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <deque>
+#include <memory>
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <cstdint>
+
+/**
+ * Delta-encoded Memento.
+ *
+ * Only every N-th memento stores the full state (a keyframe); the ones in
+ * between store the difference to their predecessor as "keep a prefix, keep a
+ * suffix, replace the middle". A state is rebuilt by starting at the closest
+ * keyframe and replaying the deltas forward. Payloads are run-length encoded
+ * when that makes them smaller. The Caretaker enforces a memory budget by
+ * dropping the oldest mementos, turning the new oldest one into a keyframe.
+ */
+
+/**
+ * A minimal byte-oriented run-length codec: (run length, byte) pairs. It is
+ * only used when the result is shorter than the input.
+ */
+class RunLength {
+public:
+    static std::string Encode(std::string_view in) {
+        std::string out;
+        for (size_t i = 0; i < in.size();) {
+            size_t run = 1;
+            while (i + run < in.size() && in[i + run] == in[i] && run < 255) {
+                ++run;
+            }
+            out.push_back(static_cast<char>(run));
+            out.push_back(in[i]);
+            i += run;
+        }
+        return out;
+    }
+
+    static std::string Decode(std::string_view in) {
+        std::string out;
+        for (size_t i = 0; i + 1 < in.size(); i += 2) {
+            out.append(static_cast<unsigned char>(in[i]), in[i + 1]);
+        }
+        return out;
+    }
+};
+
+/**
+ * The Memento interface provides a way to retrieve the memento's metadata, such
+ * as creation date or name. However, it doesn't expose the Originator's state.
+ */
+class Memento {
+public:
+    virtual ~Memento() {}
+    virtual std::string GetName() const = 0;
+    virtual std::string date() const = 0;
+    virtual std::string state() const = 0;
+    /**
+     * Bytes this memento keeps alive, including the object itself.
+     */
+    virtual size_t bytes() const = 0;
+    virtual bool keyframe() const = 0;
+    /**
+     * Turns the memento into a keyframe so its predecessors can be discarded.
+     */
+    virtual void Flatten() = 0;
+};
+
+/**
+ * The Concrete Memento contains the infrastructure for storing the Originator's
+ * state, either in full or as a delta against the previous memento.
+ */
+class ConcreteMemento : public Memento {
+private:
+    const ConcreteMemento *base_;
+    size_t depth_;
+    uint32_t prefix_ = 0;
+    uint32_t suffix_ = 0;
+    bool compressed_ = false;
+    std::string payload_;
+    std::string preview_;
+    std::string date_;
+
+    void SetPayload(std::string_view raw) {
+        std::string packed = RunLength::Encode(raw);
+        this->compressed_ = packed.size() < raw.size();
+        this->payload_ = this->compressed_ ? std::move(packed) : std::string(raw);
+        this->payload_.shrink_to_fit();
+    }
+
+    std::string Raw() const {
+        return this->compressed_ ? RunLength::Decode(this->payload_) : this->payload_;
+    }
+
+    /**
+     * Applies this memento's delta to its predecessor's state.
+     */
+    void Apply(std::string &state) const {
+        std::string middle = this->Raw();
+        state.replace(this->prefix_, state.size() - this->prefix_ - this->suffix_, middle);
+    }
+
+public:
+    /**
+     * `base` and `base_state` describe the previous memento; pass nullptr to
+     * force a keyframe.
+     */
+    ConcreteMemento(const std::string &state, const ConcreteMemento *base, const std::string &base_state, size_t keyframe_interval)
+        : base_(base), depth_(base ? base->depth_ + 1 : 0), preview_(state.substr(0, 9)) {
+        std::time_t now = std::time(0);
+        this->date_ = std::ctime(&now);
+        if (this->base_ == nullptr || this->depth_ >= keyframe_interval) {
+            this->base_ = nullptr;
+            this->depth_ = 0;
+            this->SetPayload(state);
+            return;
+        }
+        size_t limit = std::min(state.size(), base_state.size());
+        size_t prefix = std::mismatch(state.begin(), state.begin() + limit, base_state.begin()).first - state.begin();
+        size_t suffix = 0;
+        while (suffix < limit - prefix && state[state.size() - 1 - suffix] == base_state[base_state.size() - 1 - suffix]) {
+            ++suffix;
+        }
+        this->prefix_ = static_cast<uint32_t>(prefix);
+        this->suffix_ = static_cast<uint32_t>(suffix);
+        this->SetPayload(std::string_view(state).substr(prefix, state.size() - prefix - suffix));
+    }
+
+    /**
+     * The Originator uses this method when restoring its state. It walks back
+     * to the keyframe and replays the deltas from there.
+     */
+    std::string state() const override {
+        const ConcreteMemento *chain[64];
+        size_t length = 0;
+        const ConcreteMemento *m = this;
+        for (; m->base_ != nullptr; m = m->base_) {
+            chain[length++] = m;
+        }
+        std::string state = m->Raw();
+        while (length > 0) {
+            chain[--length]->Apply(state);
+        }
+        return state;
+    }
+
+    void Flatten() override {
+        if (this->base_ == nullptr) {
+            return;
+        }
+        this->SetPayload(this->state());
+        this->base_ = nullptr;
+        this->depth_ = 0;
+        this->prefix_ = this->suffix_ = 0;
+    }
+
+    size_t bytes() const override {
+        return sizeof(*this) + this->payload_.capacity();
+    }
+
+    bool keyframe() const override {
+        return this->base_ == nullptr;
+    }
+
+    /**
+     * The rest of the methods are used by the Caretaker to display metadata.
+     */
+    std::string GetName() const override {
+        return this->date_ + " / (" + this->preview_ + "...)";
+    }
+    std::string date() const override {
+        return this->date_;
+    }
+
+    /**
+     * Deltas can only be chained this deep; see state().
+     */
+    static constexpr size_t kMaxKeyframeInterval = 64;
+};
+
+/**
+ * The Originator holds some important state that may change over time. It also
+ * defines a method for saving the state inside a memento and another method for
+ * restoring the state from it.
+ */
+class Originator {
+    /**
+     * @var string For the sake of simplicity, the originator's state is stored
+     * inside a single variable.
+     */
+private:
+    std::string state_;
+    /**
+     * The state as of the last memento this originator produced, so the next
+     * delta doesn't have to replay history.
+     */
+    const Memento *last_saved_ = nullptr;
+    std::string last_saved_state_;
+
+public:
+    Originator(std::string state) : state_(state) {
+        std::cout << "Originator: My initial state is: " << this->state_.substr(0, 30) << "... (" << this->state_.size() << " bytes)\n";
+    }
+    /**
+     * The Originator's business logic may affect its internal state. Therefore,
+     * the client should backup the state before launching methods of the business
+     * logic via the save() method.
+     */
+    void DoSomething() {
+        size_t at = std::rand() % this->state_.size();
+        size_t length = std::min<size_t>(1 + std::rand() % 16, this->state_.size() - at);
+        for (size_t i = 0; i < length; ++i) {
+            this->state_[at + i] = static_cast<char>('A' + std::rand() % 26);
+        }
+    }
+
+    /**
+     * Saves the current state inside a memento, as a delta against `previous`
+     * when possible.
+     */
+    Memento *Save(const Memento *previous, size_t keyframe_interval) {
+        if (previous != nullptr && previous != this->last_saved_) {
+            this->last_saved_state_ = previous->state();
+        }
+        Memento *memento = new ConcreteMemento(this->state_, static_cast<const ConcreteMemento *>(previous), this->last_saved_state_, keyframe_interval);
+        this->last_saved_ = memento;
+        this->last_saved_state_ = this->state_;
+        return memento;
+    }
+
+    /**
+     * Restores the Originator's state from an already rebuilt memento state.
+     */
+    void Restore(std::string state) {
+        this->state_ = std::move(state);
+        std::cout << "Originator: My state has changed to: " << this->state_.substr(0, 30) << "...\n";
+    }
+
+    const std::string &state() const {
+        return this->state_;
+    }
+};
+
+/**
+ * The Caretaker doesn't depend on the Concrete Memento class. Therefore, it
+ * doesn't have access to the originator's state, stored inside the memento. It
+ * works with all mementos via the base Memento interface.
+ */
+class Caretaker {
+private:
+    std::deque<std::unique_ptr<Memento>> mementos_;
+    Originator *originator_;
+    size_t keyframe_interval_;
+    size_t budget_bytes_;
+    size_t bytes_ = 0;
+    size_t evicted_ = 0;
+    size_t restores_ = 0;
+    std::chrono::nanoseconds restore_time_{0};
+    std::chrono::nanoseconds last_restore_{0};
+
+    /**
+     * Drops the oldest mementos until the history fits the budget. The newest
+     * memento is always kept.
+     */
+    void Evict() {
+        while (this->bytes_ > this->budget_bytes_ && this->mementos_.size() > 1) {
+            Memento *next = this->mementos_[1].get();
+            this->bytes_ -= next->bytes();
+            next->Flatten();
+            this->bytes_ += next->bytes();
+            this->bytes_ -= this->mementos_.front()->bytes();
+            this->mementos_.pop_front();
+            ++this->evicted_;
+        }
+    }
+
+public:
+    Caretaker(Originator *originator, size_t keyframe_interval, size_t budget_bytes)
+        : originator_(originator), keyframe_interval_(std::min(keyframe_interval, ConcreteMemento::kMaxKeyframeInterval)), budget_bytes_(budget_bytes) {}
+
+    void Backup() {
+        const Memento *previous = this->mementos_.empty() ? nullptr : this->mementos_.back().get();
+        this->mementos_.emplace_back(this->originator_->Save(previous, this->keyframe_interval_));
+        this->bytes_ += this->mementos_.back()->bytes();
+        this->Evict();
+    }
+
+    void Undo() {
+        if (this->mementos_.empty()) {
+            return;
+        }
+        std::unique_ptr<Memento> memento = std::move(this->mementos_.back());
+        this->mementos_.pop_back();
+        this->bytes_ -= memento->bytes();
+        std::cout << "Caretaker: Restoring state to: " << memento->GetName() << "\n";
+        auto begin = std::chrono::steady_clock::now();
+        std::string state = memento->state();
+        this->last_restore_ = std::chrono::steady_clock::now() - begin;
+        this->restore_time_ += this->last_restore_;
+        ++this->restores_;
+        this->originator_->Restore(std::move(state));
+    }
+
+    void ShowHistory() const {
+        std::cout << "Caretaker: " << this->mementos_.size() << " mementos, " << this->bytes_ << " bytes (budget "
+                  << this->budget_bytes_ << "), " << this->evicted_ << " evicted. Newest ones:\n";
+        size_t first = this->mementos_.size() > 5 ? this->mementos_.size() - 5 : 0;
+        for (size_t i = first; i < this->mementos_.size(); ++i) {
+            const Memento &memento = *this->mementos_[i];
+            std::cout << (memento.keyframe() ? "  keyframe " : "  delta    ") << memento.bytes() << " B  " << memento.GetName() << "\n";
+        }
+    }
+
+    void ShowRestoreLatency() const {
+        std::cout << "Caretaker: last restore " << this->last_restore_.count() << " ns, average "
+                  << (this->restores_ ? this->restore_time_.count() / this->restores_ : 0) << " ns over " << this->restores_ << " restores\n";
+    }
+};
+
+/**
+ * Client code.
+ */
+
+void ClientCode() {
+    const size_t state_size = 64 * 1024;
+    std::string document;
+    while (document.size() < state_size) {
+        document += "Super-duper-super-puper-super. ";
+    }
+    document.resize(state_size);
+    Originator *originator = new Originator(document);
+    Caretaker *caretaker = new Caretaker(originator, 16, 1024 * 1024);
+    std::string saved[3];
+    for (int i = 0; i < 1000; ++i) {
+        caretaker->Backup();
+        if (i >= 997) {
+            saved[i - 997] = originator->state();
+        }
+        originator->DoSomething();
+    }
+    std::cout << "\n";
+    caretaker->ShowHistory();
+    std::cout << "Full copies of the same 1000 states would take " << 1000 * state_size << " bytes.\n";
+
+    std::cout << "\nClient: Now, let's rollback!\n\n";
+    for (int i = 2; i >= 0; --i) {
+        caretaker->Undo();
+        std::cout << "Client: restored state is " << (originator->state() == saved[i] ? "exact" : "WRONG") << "\n";
+    }
+    caretaker->ShowRestoreLatency();
+
+    delete originator;
+    delete caretaker;
+}
+
+int main() {
+    std::srand(static_cast<unsigned int>(std::time(NULL)));
+    ClientCode();
+    return 0;
+}
@@ -9,6 +9,7 @@
  */
 class Memento {
 public:
+    virtual ~Memento() {}
     virtual std::string GetName() const = 0;
     virtual std::string date() const = 0;
     virtual std::string state() const = 0;
@@ -0,0 +1,524 @@
+/**
+ * Observer Design Pattern (asynchronous notifications)
+ *
+ * Intent: Lets you define a subscription mechanism to notify multiple objects
+ * about any events that happen to the object they're observing.
+ *
+ * In this variant Notify() does not call anybody. The message is published
+ * once as an immutable, reference-counted payload and pushed onto a lock-free
+ * queue per observer; a thread pool delivers it. A slow observer only delays
+ * its own mailbox, never the publisher or the other observers.
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+
+class IObserver {
+public:
+    virtual ~IObserver() {};
+    /**
+     * With Ordering::Unordered this may be called from several pool threads at
+     * once, so observers used that way must be thread-safe.
+     */
+    virtual void Update(const std::string &message_from_subject) = 0;
+};
+
+/**
+ * The payload is created once per Notify and shared by every delivery.
+ */
+using Payload = std::shared_ptr<const std::string>;
+
+/**
+ * A log2-bucketed histogram of publish-to-deliver latencies in nanoseconds.
+ * Recording is one relaxed atomic increment.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int kBuckets = 64;
+
+    void Record(uint64_t ns) {
+        int bucket = 0;
+        while (bucket + 1 < kBuckets && (ns >> bucket) > 1) {
+            ++bucket;
+        }
+        buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Merge(const LatencyHistogram &other) {
+        for (int i = 0; i < kBuckets; ++i) {
+            buckets_[i].fetch_add(other.buckets_[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t Count() const {
+        uint64_t total = 0;
+        for (const auto &bucket : buckets_) {
+            total += bucket.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    /**
+     * Upper bound (in ns) of the bucket holding the given percentile.
+     */
+    uint64_t Percentile(double percentile) const {
+        uint64_t total = Count();
+        uint64_t rank = static_cast<uint64_t>(total * percentile / 100.0);
+        uint64_t seen = 0;
+        for (int i = 0; i < kBuckets; ++i) {
+            seen += buckets_[i].load(std::memory_order_relaxed);
+            if (total != 0 && seen > rank) {
+                return uint64_t(2) << i;
+            }
+        }
+        return 0;
+    }
+
+private:
+    std::atomic<uint64_t> buckets_[kBuckets] = {};
+};
+
+/**
+ * A fixed set of worker threads pulling tasks from a shared queue.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threads) {
+        for (size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back([this] { this->Run(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        ready_.notify_all();
+        for (std::thread &worker : workers_) {
+            worker.join();
+        }
+    }
+
+    void Submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        ready_.notify_one();
+    }
+
+private:
+    void Run() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                ready_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+                if (tasks_.empty()) {
+                    return;
+                }
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<std::function<void()>> tasks_;
+    std::vector<std::thread> workers_;
+    bool stopping_ = false;
+};
+
+/**
+ * One observer's inbox: an intrusive multi-producer, single-consumer queue
+ * (Vyukov's design). Pushes are one atomic exchange; only the thread that
+ * currently owns the mailbox pops.
+ */
+class Mailbox {
+public:
+    struct Node {
+        std::atomic<Node *> next_{nullptr};
+        Payload payload_;
+        std::chrono::steady_clock::time_point published_;
+    };
+
+    explicit Mailbox(IObserver *observer) : observer_(observer), head_(&stub_), tail_(&stub_) {}
+
+    ~Mailbox() {
+        while (Node *node = Pop()) {
+            delete node;
+        }
+    }
+
+    void Push(Node *node) {
+        node->next_.store(nullptr, std::memory_order_relaxed);
+        Node *previous = head_.exchange(node, std::memory_order_acq_rel);
+        previous->next_.store(node, std::memory_order_release);
+        if (node != &stub_) {
+            size_.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    /**
+     * Number of fully pushed, not yet popped nodes.
+     */
+    size_t size() const {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Returns the oldest node, or nullptr if the queue is empty or a push is
+     * still halfway through.
+     */
+    Node *Pop() {
+        Node *tail = tail_;
+        Node *next = tail->next_.load(std::memory_order_acquire);
+        if (tail == &stub_) {
+            if (next == nullptr) {
+                return nullptr;
+            }
+            tail_ = next;
+            tail = next;
+            next = next->next_.load(std::memory_order_acquire);
+        }
+        if (next != nullptr) {
+            tail_ = next;
+            size_.fetch_sub(1, std::memory_order_relaxed);
+            return tail;
+        }
+        if (tail != head_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        Push(&stub_);
+        next = tail->next_.load(std::memory_order_acquire);
+        if (next != nullptr) {
+            tail_ = next;
+            size_.fetch_sub(1, std::memory_order_relaxed);
+            return tail;
+        }
+        return nullptr;
+    }
+
+    /**
+     * Hands the payload to the observer unless it has been detached, and
+     * records how long it waited.
+     */
+    void Deliver(const Payload &payload, std::chrono::steady_clock::time_point published) {
+        in_flight_.fetch_add(1, std::memory_order_seq_cst);
+        if (!closed_.load(std::memory_order_seq_cst)) {
+            latency_.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - published).count());
+            observer_->Update(*payload);
+        }
+        in_flight_.fetch_sub(1, std::memory_order_release);
+    }
+
+    /**
+     * After Close() returns the observer will not be called again and may be
+     * destroyed.
+     */
+    void Close() {
+        closed_.store(true, std::memory_order_seq_cst);
+        while (in_flight_.load(std::memory_order_acquire) != 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    IObserver *observer() const {
+        return observer_;
+    }
+
+    const LatencyHistogram &latency() const {
+        return latency_;
+    }
+
+    /**
+     * Set while a drain task for this mailbox is queued or running, so that
+     * at most one pool thread consumes it at a time.
+     */
+    std::atomic<bool> scheduled_{false};
+
+private:
+    IObserver *observer_;
+    Node stub_;
+    std::atomic<Node *> head_;
+    Node *tail_;
+    std::atomic<size_t> size_{0};
+    std::atomic<bool> closed_{false};
+    std::atomic<int> in_flight_{0};
+    LatencyHistogram latency_;
+};
+
+/**
+ * The Subject owns some important state and notifies observers when the state
+ * changes.
+ */
+class AsyncSubject {
+public:
+    enum class Ordering {
+        /**
+         * Each observer sees messages in publish order, one at a time.
+         * Different observers are served in parallel.
+         */
+        PerObserverFifo,
+        /**
+         * Messages still go through the observer's mailbox, but whoever
+         * drains it hands full batches to other pool threads: maximum
+         * parallelism, no ordering, and an observer may be called
+         * concurrently.
+         */
+        Unordered
+    };
+
+    AsyncSubject(ThreadPool &pool, Ordering ordering) : pool_(pool), ordering_(ordering), mailboxes_(std::make_shared<MailboxList>()) {}
+
+    virtual ~AsyncSubject() {
+        Drain();
+        std::cout << "Goodbye, I was the Subject.\n";
+    }
+
+    /**
+     * The subscription management methods. The mailbox list is copy-on-write:
+     * Notify only loads the current list, it never waits for Attach/Detach.
+     */
+    void Attach(IObserver *observer) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto next = std::make_shared<MailboxList>(*std::atomic_load(&mailboxes_));
+        next->push_back(std::make_shared<Mailbox>(observer));
+        std::atomic_store(&mailboxes_, std::shared_ptr<const MailboxList>(std::move(next)));
+    }
+
+    void Detach(IObserver *observer) {
+        std::shared_ptr<Mailbox> removed;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto next = std::make_shared<MailboxList>(*std::atomic_load(&mailboxes_));
+            auto it = std::find_if(next->begin(), next->end(), [observer](const std::shared_ptr<Mailbox> &m) { return m->observer() == observer; });
+            if (it == next->end()) {
+                return;
+            }
+            removed = *it;
+            next->erase(it);
+            std::atomic_store(&mailboxes_, std::shared_ptr<const MailboxList>(std::move(next)));
+        }
+        removed->Close();
+        std::lock_guard<std::mutex> lock(mutex_);
+        retired_.Merge(removed->latency());
+    }
+
+    /**
+     * Publishes the current message: one allocation for the payload, then one
+     * queue push per observer. Returns without waiting for any observer.
+     */
+    void Notify() {
+        Payload payload = std::make_shared<const std::string>(message_);
+        auto published = std::chrono::steady_clock::now();
+        std::shared_ptr<const MailboxList> mailboxes = std::atomic_load(&mailboxes_);
+        pending_.fetch_add(mailboxes->size(), std::memory_order_relaxed);
+        for (const std::shared_ptr<Mailbox> &mailbox : *mailboxes) {
+            mailbox->Push(new Mailbox::Node{{nullptr}, payload, published});
+            if (!mailbox->scheduled_.exchange(true, std::memory_order_acq_rel)) {
+                pool_.Submit([this, mailbox] { DrainMailbox(mailbox); });
+            }
+        }
+    }
+
+    void CreateMessage(std::string message = "Empty") {
+        this->message_ = std::move(message);
+        Notify();
+    }
+
+    /**
+     * Usually, the subscription logic is only a fraction of what a Subject can
+     * really do. Subjects commonly hold some important business logic, that
+     * triggers a notification method whenever something important is about to
+     * happen (or after it).
+     */
+    void SomeBusinessLogic() {
+        this->message_ = "change message message";
+        Notify();
+        std::cout << "I'm about to do some thing important\n";
+    }
+
+    /**
+     * Waits until every message published so far has been delivered.
+     */
+    void Drain() {
+        std::unique_lock<std::mutex> lock(drained_mutex_);
+        drained_.wait(lock, [this] { return pending_.load(std::memory_order_acquire) == 0; });
+    }
+
+    /**
+     * Latencies of all observers, including ones that have been detached.
+     */
+    std::unique_ptr<LatencyHistogram> Latency() const {
+        auto total = std::make_unique<LatencyHistogram>();
+        std::lock_guard<std::mutex> lock(mutex_);
+        total->Merge(retired_);
+        for (const std::shared_ptr<Mailbox> &mailbox : *std::atomic_load(&mailboxes_)) {
+            total->Merge(mailbox->latency());
+        }
+        return total;
+    }
+
+private:
+    using MailboxList = std::vector<std::shared_ptr<Mailbox>>;
+
+    /**
+     * Unordered drains hand off popped messages to other pool threads in
+     * batches of this many, so one task carries many deliveries.
+     */
+    static constexpr size_t kUnorderedBatch = 16;
+
+    /**
+     * Runs on a pool thread that owns the mailbox. After emptying it, the task
+     * gives up ownership and then re-checks the size: a message pushed in
+     * between is either seen here or its publisher schedules a new task.
+     *
+     * Only this task pops, in either ordering. Unordered, it chains the popped
+     * nodes together through their (now unused) next_ links and submits every
+     * full chain as a task of its own; the last partial chain it delivers
+     * itself.
+     */
+    void DrainMailbox(const std::shared_ptr<Mailbox> &mailbox) {
+        do {
+            Mailbox::Node *chain = nullptr;
+            size_t chained = 0, delivered = 0;
+            while (Mailbox::Node *node = mailbox->Pop()) {
+                if (ordering_ == Ordering::PerObserverFifo) {
+                    mailbox->Deliver(node->payload_, node->published_);
+                    delete node;
+                    ++delivered;
+                    continue;
+                }
+                node->next_.store(chain, std::memory_order_relaxed);
+                chain = node;
+                if (++chained == kUnorderedBatch) {
+                    pool_.Submit([this, mailbox, chain] { DeliverChain(*mailbox, chain, kUnorderedBatch); });
+                    chain = nullptr;
+                    chained = 0;
+                }
+            }
+            if (chain != nullptr) {
+                DeliverChain(*mailbox, chain, chained);
+            }
+            Delivered(delivered);
+            mailbox->scheduled_.exchange(false, std::memory_order_acq_rel);
+        } while (mailbox->size() != 0 && !mailbox->scheduled_.exchange(true, std::memory_order_acq_rel));
+    }
+
+    void DeliverChain(Mailbox &mailbox, Mailbox::Node *chain, size_t count) {
+        while (chain != nullptr) {
+            Mailbox::Node *next = chain->next_.load(std::memory_order_relaxed);
+            mailbox.Deliver(chain->payload_, chain->published_);
+            delete chain;
+            chain = next;
+        }
+        Delivered(count);
+    }
+
+    /**
+     * The decrement happens under drained_mutex_, which Drain() holds while
+     * it checks pending_. So Drain() (and with it the destructor) cannot
+     * return until this function has released the mutex, and it touches
+     * nothing of the subject after that.
+     */
+    void Delivered(size_t count) {
+        if (count == 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(drained_mutex_);
+        if (pending_.fetch_sub(count, std::memory_order_acq_rel) == count) {
+            drained_.notify_all();
+        }
+    }
+
+    ThreadPool &pool_;
+    Ordering ordering_;
+    std::string message_;
+
+    mutable std::mutex mutex_;
+    std::shared_ptr<const MailboxList> mailboxes_;
+    LatencyHistogram retired_;
+
+    std::atomic<size_t> pending_{0};
+    std::mutex drained_mutex_;
+    std::condition_variable drained_;
+};
+
+class Observer : public IObserver {
+public:
+    Observer(AsyncSubject &subject, int number, std::chrono::microseconds delay) : subject_(subject), number_(number), delay_(delay) {
+        this->subject_.Attach(this);
+    }
+
+    void Update(const std::string &message_from_subject) override {
+        std::this_thread::sleep_for(delay_);
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++received_;
+        last_message_ = message_from_subject;
+    }
+
+    void RemoveMeFromTheList() {
+        subject_.Detach(this);
+    }
+
+    void PrintInfo() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::cout << "Observer \"" << this->number_ << "\": " << received_ << " messages, last --> " << last_message_ << "\n";
+    }
+
+private:
+    AsyncSubject &subject_;
+    int number_;
+    std::chrono::microseconds delay_;
+    std::mutex mutex_;
+    int received_ = 0;
+    std::string last_message_;
+};
+
+void ClientCode(ThreadPool &pool, AsyncSubject::Ordering ordering, const char *name) {
+    std::cout << "\nOrdering: " << name << "\n";
+    AsyncSubject subject(pool, ordering);
+    std::vector<std::unique_ptr<Observer>> observers;
+    for (int i = 1; i <= 8; ++i) {
+        // Observer 1 is the slow one; nobody else should wait for it.
+        observers.push_back(std::make_unique<Observer>(subject, i, std::chrono::microseconds(i == 1 ? 2000 : 10)));
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < 100; ++i) {
+        subject.CreateMessage("message #" + std::to_string(i));
+    }
+    subject.SomeBusinessLogic();
+    auto publish = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+    observers[3]->RemoveMeFromTheList();
+    subject.Drain();
+
+    std::cout << "Published 101 messages in " << publish.count() << " us.\n";
+    for (const std::unique_ptr<Observer> &observer : observers) {
+        observer->PrintInfo();
+    }
+    std::unique_ptr<LatencyHistogram> latency = subject.Latency();
+    std::cout << "Publish-to-deliver latency over " << latency->Count() << " deliveries: p50 <= " << latency->Percentile(50)
+              << " ns, p99 <= " << latency->Percentile(99) << " ns\n";
+}
+
+int main() {
+    ThreadPool pool(4);
+    ClientCode(pool, AsyncSubject::Ordering::PerObserverFifo, "per-observer FIFO");
+    ClientCode(pool, AsyncSubject::Ordering::Unordered, "unordered");
+    return 0;
+}
@@ -0,0 +1,382 @@
+/**
+ * Observer Design Pattern (contiguous registry with snapshot notifications)
+ *
+ * Intent: Lets you define a subscription mechanism to notify multiple objects
+ * about any events that happen to the object they're observing.
+ *
+ * This variant is meant for tens of thousands of subscribers. Observers live
+ * in a flat slot array and are identified by a handle (slot index plus
+ * generation), so Detach is O(1) and a stale handle can never remove someone
+ * else. Notify iterates over an immutable, compacted snapshot of the live
+ * observers, so other threads may Attach and Detach while it runs.
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * Identifies one subscription. The generation changes every time a slot is
+ * reused, so detaching with an old handle is a harmless no-op.
+ */
+struct ObserverHandle {
+    uint32_t index_;
+    uint32_t generation_;
+};
+
+/**
+ * The registry stores entries in contiguous slots with a free list of vacant
+ * indices. Readers never touch the slots: they get a shared, immutable
+ * snapshot vector, rebuilt lazily by the first Snapshot() call after a change.
+ * The cost of a rebuild is paid once per burst of changes, not once per
+ * notification or per change.
+ */
+template <typename Entry>
+class ObserverRegistry {
+public:
+    using SnapshotPtr = std::shared_ptr<const std::vector<Entry>>;
+
+    ObserverHandle Attach(Entry entry) {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        uint32_t index;
+        if (!this->free_.empty()) {
+            index = this->free_.back();
+            this->free_.pop_back();
+        } else {
+            index = static_cast<uint32_t>(this->slots_.size());
+            this->slots_.push_back({});
+        }
+        Slot &slot = this->slots_[index];
+        slot.entry_ = entry;
+        slot.live_ = true;
+        ++this->live_;
+        this->dirty_ = true;
+        return {index, slot.generation_};
+    }
+
+    bool Detach(ObserverHandle handle) {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        if (handle.index_ >= this->slots_.size()) {
+            return false;
+        }
+        Slot &slot = this->slots_[handle.index_];
+        if (!slot.live_ || slot.generation_ != handle.generation_) {
+            return false;
+        }
+        slot.live_ = false;
+        ++slot.generation_;
+        this->free_.push_back(handle.index_);
+        --this->live_;
+        this->dirty_ = true;
+        return true;
+    }
+
+    SnapshotPtr Snapshot() {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        if (this->dirty_ || !this->snapshot_) {
+            auto fresh = std::make_shared<std::vector<Entry>>();
+            fresh->reserve(this->live_);
+            for (const Slot &slot : this->slots_) {
+                if (slot.live_) {
+                    fresh->push_back(slot.entry_);
+                }
+            }
+            if (this->snapshot_) {
+                this->PruneRetired();
+                this->retired_.push_back(this->snapshot_);
+            }
+            this->snapshot_ = std::move(fresh);
+            this->dirty_ = false;
+        }
+        return this->snapshot_;
+    }
+
+    /**
+     * A detached observer may still receive a notification that was already
+     * in flight on another thread. Call Quiesce() after Detach and before
+     * destroying the observer to wait until every older snapshot is released.
+     */
+    void Quiesce() {
+        this->Snapshot();
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lock(this->mutex_);
+                this->PruneRetired();
+                if (this->retired_.empty()) {
+                    return;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        return this->live_;
+    }
+
+private:
+    struct Slot {
+        Entry entry_{};
+        uint32_t generation_ = 0;
+        bool live_ = false;
+    };
+
+    void PruneRetired() {
+        size_t kept = 0;
+        for (size_t i = 0; i < this->retired_.size(); ++i) {
+            if (!this->retired_[i].expired()) {
+                this->retired_[kept++] = std::move(this->retired_[i]);
+            }
+        }
+        this->retired_.resize(kept);
+    }
+
+    mutable std::mutex mutex_;
+    std::vector<Slot> slots_;
+    std::vector<uint32_t> free_;
+    size_t live_ = 0;
+    bool dirty_ = false;
+    SnapshotPtr snapshot_;
+    std::vector<std::weak_ptr<const std::vector<Entry>>> retired_;
+};
+
+class IObserver {
+public:
+    virtual ~IObserver() {};
+    virtual void Update(const std::string &message_from_subject) = 0;
+};
+
+/**
+ * The Subject owns some important state and notifies observers when the state
+ * changes.
+ */
+class Subject {
+public:
+    virtual ~Subject() {
+        std::cout << "Goodbye, I was the Subject.\n";
+    }
+
+    /**
+     * The subscription management methods.
+     */
+    ObserverHandle Attach(IObserver *observer) {
+        return observers_.Attach(observer);
+    }
+
+    void Detach(ObserverHandle handle) {
+        observers_.Detach(handle);
+    }
+
+    void Notify() {
+        ObserverRegistry<IObserver *>::SnapshotPtr snapshot = observers_.Snapshot();
+        HowManyObserver(snapshot->size());
+        for (IObserver *observer : *snapshot) {
+            observer->Update(message_);
+        }
+    }
+
+    void CreateMessage(std::string message = "Empty") {
+        this->message_ = std::move(message);
+        Notify();
+    }
+
+    void HowManyObserver(size_t count) {
+        std::cout << "There are " << count << " observers in the list.\n";
+    }
+
+    /**
+     * Usually, the subscription logic is only a fraction of what a Subject can
+     * really do. Subjects commonly hold some important business logic, that
+     * triggers a notification method whenever something important is about to
+     * happen (or after it).
+     */
+    void SomeBusinessLogic() {
+        this->message_ = "change message message";
+        Notify();
+        std::cout << "I'm about to do some thing important\n";
+    }
+
+private:
+    ObserverRegistry<IObserver *> observers_;
+    std::string message_;
+};
+
+/**
+ * The typed path skips both the virtual Update call and the std::string
+ * message: each subscription is a plain function pointer plus a context
+ * pointer, stored by value in the snapshot, and the event is any type the
+ * publisher chooses.
+ */
+template <typename Event>
+class TypedSubject {
+public:
+    struct Callback {
+        void *context_;
+        void (*invoke_)(void *, const Event &);
+    };
+
+    /**
+     * Subscribes a member function. The trampoline is generated at compile
+     * time, so the call through it can be inlined into the member.
+     */
+    template <typename T, void (T::*Method)(const Event &)>
+    ObserverHandle Attach(T *observer) {
+        return callbacks_.Attach({observer, [](void *context, const Event &event) {
+                                      (static_cast<T *>(context)->*Method)(event);
+                                  }});
+    }
+
+    ObserverHandle Attach(void *context, void (*invoke)(void *, const Event &)) {
+        return callbacks_.Attach({context, invoke});
+    }
+
+    void Detach(ObserverHandle handle) {
+        callbacks_.Detach(handle);
+    }
+
+    void Quiesce() {
+        callbacks_.Quiesce();
+    }
+
+    void Publish(const Event &event) {
+        typename ObserverRegistry<Callback>::SnapshotPtr snapshot = callbacks_.Snapshot();
+        for (const Callback &callback : *snapshot) {
+            callback.invoke_(callback.context_, event);
+        }
+    }
+
+    size_t size() const {
+        return callbacks_.size();
+    }
+
+private:
+    ObserverRegistry<Callback> callbacks_;
+};
+
+class Observer : public IObserver {
+public:
+    Observer(Subject &subject) : subject_(subject) {
+        this->handle_ = this->subject_.Attach(this);
+        std::cout << "Hi, I'm the Observer \"" << ++Observer::static_number_ << "\".\n";
+        this->number_ = Observer::static_number_;
+    }
+
+    virtual ~Observer() {
+        std::cout << "Goodbye, I was the Observer \"" << this->number_ << "\".\n";
+    }
+
+    void Update(const std::string &message_from_subject) override {
+        message_from_subject_ = message_from_subject;
+        PrintInfo();
+    }
+
+    void RemoveMeFromTheList() {
+        subject_.Detach(handle_);
+        std::cout << "Observer \"" << number_ << "\" removed from the list.\n";
+    }
+
+    void PrintInfo() {
+        std::cout << "Observer \"" << this->number_ << "\": a new message is available --> " << this->message_from_subject_ << "\n";
+    }
+
+private:
+    std::string message_from_subject_;
+    Subject &subject_;
+    ObserverHandle handle_;
+    static int static_number_;
+    int number_;
+};
+
+int Observer::static_number_ = 0;
+
+struct PriceTick {
+    uint32_t instrument_;
+    double price_;
+};
+
+class PriceCounter {
+public:
+    void OnTick(const PriceTick &tick) {
+        ++ticks_;
+        last_price_ = tick.price_;
+    }
+
+    uint64_t ticks_ = 0;
+    double last_price_ = 0;
+};
+
+void ClientCode() {
+    Subject *subject = new Subject;
+    Observer *observer1 = new Observer(*subject);
+    Observer *observer2 = new Observer(*subject);
+    Observer *observer3 = new Observer(*subject);
+    Observer *observer4;
+    Observer *observer5;
+
+    subject->CreateMessage("Hello World! :D");
+    observer3->RemoveMeFromTheList();
+
+    subject->CreateMessage("The weather is hot today! :p");
+    observer4 = new Observer(*subject);
+
+    observer2->RemoveMeFromTheList();
+    observer5 = new Observer(*subject);
+
+    subject->CreateMessage("My new car is great! ;)");
+    observer5->RemoveMeFromTheList();
+
+    observer4->RemoveMeFromTheList();
+    observer1->RemoveMeFromTheList();
+
+    delete observer5;
+    delete observer4;
+    delete observer3;
+    delete observer2;
+    delete observer1;
+    delete subject;
+}
+
+/**
+ * Fans a typed event out to many subscribers while another thread keeps
+ * subscribing and unsubscribing.
+ */
+void TypedClientCode() {
+    const size_t subscribers = 50000;
+    TypedSubject<PriceTick> ticker;
+    std::vector<PriceCounter> counters(subscribers);
+    for (PriceCounter &counter : counters) {
+        ticker.Attach<PriceCounter, &PriceCounter::OnTick>(&counter);
+    }
+
+    PriceCounter churn;
+    std::thread churner([&ticker, &churn] {
+        for (int i = 0; i < 1000; ++i) {
+            ObserverHandle handle = ticker.Attach<PriceCounter, &PriceCounter::OnTick>(&churn);
+            ticker.Detach(handle);
+        }
+    });
+
+    const int ticks = 200;
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < ticks; ++i) {
+        ticker.Publish({7, 100.0 + i});
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin);
+    churner.join();
+    ticker.Quiesce();
+
+    std::cout << "\nTypedSubject: " << ticks << " ticks to " << subscribers << " subscribers, "
+              << elapsed.count() / (static_cast<double>(ticks) * subscribers) << " ns per delivery, last price "
+              << counters.back().last_price_ << ", " << ticker.size() << " still attached.\n";
+}
+
+int main() {
+    ClientCode();
+    TypedClientCode();
+    return 0;
+}
@@ -0,0 +1,277 @@
+/**
+ * A chain of responsibility that can be compiled into a dispatch table.
+ *
+ * Each handler says which requests it accepts and how it answers them. The
+ * chain still works as usual through SetNext() and Handle(). When it is
+ * finished, CompiledChain::Compile() walks it once from any starting handler
+ * and builds a hash table from request to handler. A request then costs one
+ * hash and one compare, whatever the chain length, and the answer is
+ * appended to a buffer owned by the caller.
+ */
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <random>
+#include <chrono>
+#include <cstdint>
+
+class Handler {
+public:
+    virtual ~Handler() {}
+    virtual Handler *SetNext(Handler *handler) = 0;
+    virtual Handler *GetNext() const = 0;
+    virtual std::string Handle(std::string request) = 0;
+    /**
+     * The requests this handler takes.
+     */
+    virtual const std::vector<std::string> &Accepts() const = 0;
+    /**
+     * Appends the answer to an accepted request to `out`.
+     */
+    virtual void Respond(std::string_view request, std::string &out) const = 0;
+};
+
+/**
+ * The default chaining behavior can be implemented inside a base handler class.
+ */
+class AbstractHandler : public Handler {
+private:
+    Handler *next_handler_;
+    std::vector<std::string> accepts_;
+public:
+    explicit AbstractHandler(std::vector<std::string> accepts) : next_handler_(nullptr), accepts_(std::move(accepts)) {}
+    Handler *SetNext(Handler *handler) override {
+        this->next_handler_ = handler;
+        // Returning a handler from here will let us link handlers in a convenient way like this:
+        // #monkey->SetNext(#squirrel)->SetNext(#dog);
+        return handler;
+    }
+    Handler *GetNext() const override {
+        return this->next_handler_;
+    }
+    const std::vector<std::string> &Accepts() const override {
+        return this->accepts_;
+    }
+    /**
+     * The classic path: answer the request if it is accepted here, otherwise
+     * pass it on.
+     */
+    std::string Handle(std::string request) override {
+        for (const std::string &accepted : this->accepts_) {
+            if (request == accepted) {
+                std::string result;
+                this->Respond(request, result);
+                return result;
+            }
+        }
+        if (this->next_handler_) {
+            return this->next_handler_->Handle(request);
+        }
+
+        return {};
+    }
+};
+
+/**
+ * All Concrete Handlers declare what they eat and how they say so.
+ */
+class MonkeyHandler : public AbstractHandler {
+public:
+    MonkeyHandler() : AbstractHandler({"Banana"}) {}
+    void Respond(std::string_view request, std::string &out) const override {
+        out.append("Monkey: I'll eat the ").append(request).append(".\n");
+    }
+};
+
+class SquirrelHandler : public AbstractHandler {
+public:
+    SquirrelHandler() : AbstractHandler({"Nut"}) {}
+    void Respond(std::string_view request, std::string &out) const override {
+        out.append("Squirrel: I'll eat the ").append(request).append(".\n");
+    }
+};
+
+class DogHandler : public AbstractHandler {
+public:
+    DogHandler() : AbstractHandler({"MeatBall"}) {}
+    void Respond(std::string_view request, std::string &out) const override {
+        out.append("Dog: I'll eat the ").append(request).append(".\n");
+    }
+};
+
+/**
+ * The chain starting at one handler, flattened into an open-addressing hash
+ * table. When several handlers accept the same request, the one closest to
+ * the start wins, exactly as in the linked chain. Compiling from a handler in
+ * the middle gives the subchain: everything before it is left out. The table
+ * points at the handlers, so they must outlive it, and it doesn't follow
+ * later SetNext() calls; compile again after changing the chain.
+ */
+class CompiledChain {
+public:
+    static CompiledChain Compile(const Handler &start) {
+        CompiledChain chain;
+        std::vector<std::pair<std::string_view, const Handler *>> routes;
+        for (const Handler *h = &start; h != nullptr; h = h->GetNext()) {
+            for (const std::string &request : h->Accepts()) {
+                routes.emplace_back(request, h);
+            }
+        }
+        size_t capacity = 4;
+        while (capacity < routes.size() * 2) {
+            capacity *= 2;
+        }
+        chain.slots_.resize(capacity);
+        chain.mask_ = capacity - 1;
+        for (const std::pair<std::string_view, const Handler *> &route : routes) {
+            Slot &slot = chain.slots_[chain.Probe(route.first)];
+            if (slot.handler_ == nullptr) {
+                slot.key_ = std::string(route.first);
+                slot.handler_ = route.second;
+            }
+        }
+        return chain;
+    }
+
+    /**
+     * Appends the answer to `out` and returns true, or returns false if no
+     * handler in the chain accepts the request.
+     */
+    bool Handle(std::string_view request, std::string &out) const {
+        const Slot &slot = this->slots_[this->Probe(request)];
+        if (slot.handler_ == nullptr) {
+            return false;
+        }
+        slot.handler_->Respond(request, out);
+        return true;
+    }
+
+private:
+    struct Slot {
+        std::string key_;
+        const Handler *handler_ = nullptr;
+    };
+
+    static uint64_t Hash(std::string_view s) {
+        uint64_t h = 14695981039346656037ull;
+        for (char c : s) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    /**
+     * The index of the slot holding `request`, or of the empty slot where it
+     * would go. The table is at most half full, so there always is one.
+     */
+    size_t Probe(std::string_view request) const {
+        for (size_t i = Hash(request) & this->mask_;; i = (i + 1) & this->mask_) {
+            const Slot &slot = this->slots_[i];
+            if (slot.handler_ == nullptr || slot.key_ == request) {
+                return i;
+            }
+        }
+    }
+
+    std::vector<Slot> slots_;
+    size_t mask_ = 0;
+};
+
+/**
+ * The client code is usually suited to work with a single handler. In most
+ * cases, it is not even aware that the handler is part of a chain. It reuses
+ * one response buffer for all requests.
+ */
+void ClientCode(const CompiledChain &chain) {
+    std::vector<std::string_view> food = {"Nut", "Banana", "Cup of coffee"};
+    std::string result;
+    for (std::string_view f : food) {
+        std::cout << "Client: Who wants a " << f << "?\n";
+        result.clear();
+        if (chain.Handle(f, result)) {
+            std::cout << " " << result;
+        } else {
+            std::cout << " " << f << " was left untouched.\n";
+        }
+    }
+}
+
+/**
+ * A generated handler for the benchmark: animal N eats food N.
+ */
+class FoodHandler : public AbstractHandler {
+private:
+    std::string animal_;
+public:
+    FoodHandler(std::string animal, std::string food) : AbstractHandler({std::move(food)}), animal_(std::move(animal)) {}
+    void Respond(std::string_view request, std::string &out) const override {
+        out.append(this->animal_).append(": I'll eat the ").append(request).append(".\n");
+    }
+};
+
+void Benchmark() {
+    const size_t handlers = 32, requests = 1000000;
+    std::vector<std::unique_ptr<FoodHandler>> chain;
+    for (size_t i = 0; i < handlers; ++i) {
+        chain.push_back(std::make_unique<FoodHandler>("Animal" + std::to_string(i), "Food" + std::to_string(i)));
+        if (i != 0) {
+            chain[i - 1]->SetNext(chain[i].get());
+        }
+    }
+    // Some requests nobody takes, which walk the whole chain
+    std::mt19937 random(1);
+    std::vector<std::string> food;
+    for (size_t i = 0; i < requests; ++i) {
+        food.push_back("Food" + std::to_string(random() % (handlers + handlers / 4)));
+    }
+
+    size_t answered = 0, bytes = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (const std::string &f : food) {
+        std::string result = chain[0]->Handle(f);
+        answered += !result.empty();
+        bytes += result.size();
+    }
+    auto linked = std::chrono::steady_clock::now() - begin;
+
+    CompiledChain compiled = CompiledChain::Compile(*chain[0]);
+    std::string result;
+    begin = std::chrono::steady_clock::now();
+    for (const std::string &f : food) {
+        result.clear();
+        answered += compiled.Handle(f, result);
+        bytes += result.size();
+    }
+    auto table = std::chrono::steady_clock::now() - begin;
+
+    std::cout << "\n" << requests << " requests through " << handlers << " handlers (" << answered << " answered, "
+              << bytes << " bytes):\n"
+              << "  linked chain:   " << std::chrono::duration<double, std::nano>(linked).count() / requests << " ns per request\n"
+              << "  compiled table: " << std::chrono::duration<double, std::nano>(table).count() / requests << " ns per request\n";
+}
+
+/**
+ * The other part of the client code constructs the actual chain.
+ */
+int main() {
+    MonkeyHandler monkey;
+    SquirrelHandler squirrel;
+    DogHandler dog;
+    monkey.SetNext(&squirrel)->SetNext(&dog);
+
+    /**
+     * The client should be able to send a request to any handler, not just the
+     * first one in the chain. Each starting point compiles to its own table.
+     */
+    std::cout << "Chain: Monkey > Squirrel > Dog\n\n";
+    ClientCode(CompiledChain::Compile(monkey));
+    std::cout << "\n";
+    std::cout << "Subchain: Squirrel > Dog\n\n";
+    ClientCode(CompiledChain::Compile(squirrel));
+
+    Benchmark();
+    return 0;
+}
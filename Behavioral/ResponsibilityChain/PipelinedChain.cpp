@@ -0,0 +1,503 @@
+/**
+ * A chain of responsibility that works on batches of requests.
+ *
+ * Instead of sending one request down the chain at a time, a handler takes a
+ * whole RequestBatch, claims the requests it handles and passes the rest to
+ * the next handler. The virtual hop then happens once per batch rather than
+ * once per request. The same per-handler step can also run as a pipeline:
+ * every handler becomes a stage on its own thread, and the stages are joined
+ * by single-producer, single-consumer queues, so all of them can work on
+ * different batches at the same time.
+ */
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <random>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * A batch of requests and their answers. `pending_` lists the requests that
+ * no handler has claimed yet; an unclaimed request has an empty answer.
+ */
+struct RequestBatch {
+    std::vector<std::string_view> requests_;
+    std::vector<std::string> answers_;
+    std::vector<uint32_t> pending_;
+
+    void Add(std::string_view request) {
+        this->pending_.push_back(static_cast<uint32_t>(this->requests_.size()));
+        this->requests_.push_back(request);
+        this->answers_.emplace_back();
+    }
+
+    /**
+     * Forgets all answers so the same requests can be handled again.
+     */
+    void Rewind() {
+        this->pending_.clear();
+        for (uint32_t i = 0; i < this->requests_.size(); ++i) {
+            this->pending_.push_back(i);
+            this->answers_[i].clear();
+        }
+    }
+};
+
+class Handler {
+public:
+    virtual ~Handler() {}
+    virtual Handler *SetNext(Handler *handler) = 0;
+    virtual Handler *GetNext() const = 0;
+    virtual std::string Handle(std::string request) = 0;
+    /**
+     * Claims the pending requests this handler takes, leaving the others
+     * pending, and returns how many it claimed. Doesn't involve the next
+     * handler.
+     */
+    virtual size_t HandleOwn(RequestBatch &batch) = 0;
+    /**
+     * HandleOwn() on this handler and then on the rest of the chain, as far
+     * as there is anything left.
+     */
+    virtual void HandleBatch(RequestBatch &batch) = 0;
+};
+
+/**
+ * The default chaining behavior can be implemented inside a base handler class.
+ * Concrete handlers only decide about a single request in TryHandle().
+ */
+class AbstractHandler : public Handler {
+private:
+    Handler *next_handler_;
+public:
+    AbstractHandler() : next_handler_(nullptr) {}
+    Handler *SetNext(Handler *handler) override {
+        this->next_handler_ = handler;
+        // Returning a handler from here will let us link handlers in a convenient way like this:
+        // #monkey->SetNext(#squirrel)->SetNext(#dog);
+        return handler;
+    }
+    Handler *GetNext() const override {
+        return this->next_handler_;
+    }
+
+    /**
+     * Appends the answer to `out` and returns true if this handler takes the
+     * request.
+     */
+    virtual bool TryHandle(std::string_view request, std::string &out) const = 0;
+
+    std::string Handle(std::string request) override {
+        std::string result;
+        if (this->TryHandle(request, result)) {
+            return result;
+        }
+        if (this->next_handler_) {
+            return this->next_handler_->Handle(request);
+        }
+
+        return {};
+    }
+
+    /**
+     * Compacts the pending list in place: claimed requests drop out, the
+     * others keep their order.
+     */
+    size_t HandleOwn(RequestBatch &batch) override {
+        size_t kept = 0;
+        for (uint32_t index : batch.pending_) {
+            if (!this->TryHandle(batch.requests_[index], batch.answers_[index])) {
+                batch.pending_[kept++] = index;
+            }
+        }
+        size_t claimed = batch.pending_.size() - kept;
+        batch.pending_.resize(kept);
+        return claimed;
+    }
+
+    void HandleBatch(RequestBatch &batch) override {
+        this->HandleOwn(batch);
+        if (this->next_handler_ && !batch.pending_.empty()) {
+            this->next_handler_->HandleBatch(batch);
+        }
+    }
+};
+
+/**
+ * All Concrete Handlers either handle a request or pass it to the next handler in
+ * the chain.
+ */
+class MonkeyHandler : public AbstractHandler {
+public:
+    bool TryHandle(std::string_view request, std::string &out) const override {
+        if (request != "Banana") {
+            return false;
+        }
+        out.append("Monkey: I'll eat the ").append(request).append(".\n");
+        return true;
+    }
+};
+
+class SquirrelHandler : public AbstractHandler {
+public:
+    bool TryHandle(std::string_view request, std::string &out) const override {
+        if (request != "Nut") {
+            return false;
+        }
+        out.append("Squirrel: I'll eat the ").append(request).append(".\n");
+        return true;
+    }
+};
+
+class DogHandler : public AbstractHandler {
+public:
+    bool TryHandle(std::string_view request, std::string &out) const override {
+        if (request != "MeatBall") {
+            return false;
+        }
+        out.append("Dog: I'll eat the ").append(request).append(".\n");
+        return true;
+    }
+};
+
+/**
+ * A bounded queue for exactly one producer thread and one consumer thread.
+ * Both ends wait by yielding when the queue is full or empty.
+ */
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size *= 2;
+        }
+        this->slots_.resize(size);
+        this->mask_ = size - 1;
+    }
+
+    /**
+     * Moves `value` in, or returns false and leaves it alone if the queue is
+     * full.
+     */
+    bool TryPush(T &value) {
+        size_t tail = this->tail_.load(std::memory_order_relaxed);
+        if (tail - this->head_.load(std::memory_order_acquire) == this->slots_.size()) {
+            return false;
+        }
+        this->slots_[tail & this->mask_] = std::move(value);
+        this->tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool TryPop(T &value) {
+        size_t head = this->head_.load(std::memory_order_relaxed);
+        if (head == this->tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = std::move(this->slots_[head & this->mask_]);
+        this->head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    void Push(T value) {
+        while (!this->TryPush(value)) {
+            std::this_thread::yield();
+        }
+    }
+
+    T Pop() {
+        T value;
+        while (!this->TryPop(value)) {
+            std::this_thread::yield();
+        }
+        return value;
+    }
+
+private:
+    std::vector<T> slots_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+};
+
+struct StageStats {
+    size_t batches_ = 0;
+    size_t requests_ = 0;
+    size_t hits_ = 0;
+    double busy_ms_ = 0;
+
+    double hit_rate() const {
+        return this->requests_ ? static_cast<double>(this->hits_) / this->requests_ : 0;
+    }
+    /**
+     * Requests looked at per second of the stage's own working time.
+     */
+    double throughput() const {
+        return this->busy_ms_ > 0 ? this->requests_ / (this->busy_ms_ / 1000) : 0;
+    }
+};
+
+/**
+ * The chain starting at one handler, run as a pipeline with one thread per
+ * handler. Batches go in with Submit() and come out, fully handled and in the
+ * same order, from Receive(). A null batch marks the end of the stream:
+ * Close() sends one, and Receive() returns null once it has come through.
+ * Submitting and receiving should happen on different threads, since each
+ * can block while the other end is full or empty. Batches nobody received
+ * by the time the pipeline is destroyed are thrown away.
+ */
+class ChainPipeline {
+public:
+    using Batch = std::unique_ptr<RequestBatch>;
+
+    explicit ChainPipeline(Handler &start, size_t queue_capacity = 64) {
+        for (Handler *h = &start; h != nullptr; h = h->GetNext()) {
+            this->stages_.push_back(std::make_unique<Stage>(h, queue_capacity));
+        }
+        this->output_ = std::make_unique<SpscQueue<Batch>>(queue_capacity);
+        for (size_t i = 0; i < this->stages_.size(); ++i) {
+            SpscQueue<Batch> &out = i + 1 < this->stages_.size() ? this->stages_[i + 1]->input_ : *this->output_;
+            this->stages_[i]->thread_ = std::thread([this, i, &out] { this->Run(*this->stages_[i], out); });
+        }
+    }
+
+    /**
+     * Nobody receives any more, so the output is drained here: otherwise a
+     * stage blocked on a full queue would never see the end marker, and
+     * neither would its join.
+     */
+    ~ChainPipeline() {
+        Batch batch;
+        if (!this->closed_) {
+            this->closed_ = true;
+            Batch end;
+            while (!this->stages_.front()->input_.TryPush(end)) {
+                if (!this->output_->TryPop(batch)) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        if (!this->received_end_.load(std::memory_order_acquire)) {
+            while (this->output_->Pop() != nullptr) {
+            }
+        }
+        for (std::unique_ptr<Stage> &stage : this->stages_) {
+            stage->thread_.join();
+        }
+    }
+
+    void Submit(Batch batch) {
+        this->stages_.front()->input_.Push(std::move(batch));
+    }
+
+    /**
+     * Ends the stream; later calls do nothing.
+     */
+    void Close() {
+        if (this->closed_) {
+            return;
+        }
+        this->closed_ = true;
+        this->stages_.front()->input_.Push(nullptr);
+    }
+
+    Batch Receive() {
+        Batch batch = this->output_->Pop();
+        if (batch == nullptr) {
+            this->received_end_.store(true, std::memory_order_release);
+        }
+        return batch;
+    }
+
+    std::vector<StageStats> Stats() const {
+        std::vector<StageStats> stats;
+        for (const std::unique_ptr<Stage> &stage : this->stages_) {
+            StageStats s;
+            s.batches_ = stage->batches_.load(std::memory_order_relaxed);
+            s.requests_ = stage->requests_.load(std::memory_order_relaxed);
+            s.hits_ = stage->hits_.load(std::memory_order_relaxed);
+            s.busy_ms_ = stage->busy_ns_.load(std::memory_order_relaxed) / 1e6;
+            stats.push_back(s);
+        }
+        return stats;
+    }
+
+private:
+    struct Stage {
+        Stage(Handler *handler, size_t capacity) : handler_(handler), input_(capacity) {}
+        Handler *handler_;
+        SpscQueue<Batch> input_;
+        std::thread thread_;
+        std::atomic<size_t> batches_{0};
+        std::atomic<size_t> requests_{0};
+        std::atomic<size_t> hits_{0};
+        std::atomic<uint64_t> busy_ns_{0};
+    };
+
+    void Run(Stage &stage, SpscQueue<Batch> &out) {
+        for (;;) {
+            Batch batch = stage.input_.Pop();
+            if (batch == nullptr) {
+                out.Push(nullptr);
+                return;
+            }
+            auto begin = std::chrono::steady_clock::now();
+            size_t requests = batch->pending_.size();
+            size_t hits = requests != 0 ? stage.handler_->HandleOwn(*batch) : 0;
+            auto busy = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin);
+            stage.batches_.fetch_add(1, std::memory_order_relaxed);
+            stage.requests_.fetch_add(requests, std::memory_order_relaxed);
+            stage.hits_.fetch_add(hits, std::memory_order_relaxed);
+            stage.busy_ns_.fetch_add(static_cast<uint64_t>(busy.count()), std::memory_order_relaxed);
+            out.Push(std::move(batch));
+        }
+    }
+
+    std::vector<std::unique_ptr<Stage>> stages_;
+    std::unique_ptr<SpscQueue<Batch>> output_;
+    bool closed_ = false;
+    std::atomic<bool> received_end_{false};
+};
+
+/**
+ * The client code is usually suited to work with a single handler. In most
+ * cases, it is not even aware that the handler is part of a chain. Here it
+ * hands the whole order over as one batch.
+ */
+void ClientCode(Handler &handler) {
+    RequestBatch batch;
+    for (std::string_view f : {"Nut", "Banana", "Cup of coffee"}) {
+        batch.Add(f);
+    }
+    handler.HandleBatch(batch);
+    for (size_t i = 0; i < batch.requests_.size(); ++i) {
+        std::cout << "Client: Who wants a " << batch.requests_[i] << "?\n";
+        if (!batch.answers_[i].empty()) {
+            std::cout << " " << batch.answers_[i];
+        } else {
+            std::cout << " " << batch.requests_[i] << " was left untouched.\n";
+        }
+    }
+}
+
+/**
+ * A generated handler for the benchmark: animal N eats food N.
+ */
+class FoodHandler : public AbstractHandler {
+private:
+    std::string animal_;
+    std::string food_;
+public:
+    FoodHandler(std::string animal, std::string food) : animal_(std::move(animal)), food_(std::move(food)) {}
+    bool TryHandle(std::string_view request, std::string &out) const override {
+        if (request != this->food_) {
+            return false;
+        }
+        out.append(this->animal_).append(": I'll eat the ").append(request).append(".\n");
+        return true;
+    }
+};
+
+void Benchmark() {
+    const size_t handlers = 8, requests = 1000000, batch_size = 256;
+    std::vector<std::unique_ptr<FoodHandler>> chain;
+    for (size_t i = 0; i < handlers; ++i) {
+        chain.push_back(std::make_unique<FoodHandler>("Animal" + std::to_string(i), "Food" + std::to_string(i)));
+        if (i != 0) {
+            chain[i - 1]->SetNext(chain[i].get());
+        }
+    }
+    std::mt19937 random(1);
+    std::vector<std::string> food;
+    for (size_t i = 0; i < requests; ++i) {
+        food.push_back("Food" + std::to_string(random() % (handlers + 2)));
+    }
+    std::vector<ChainPipeline::Batch> batches;
+    for (size_t i = 0; i < requests; i += batch_size) {
+        batches.push_back(std::make_unique<RequestBatch>());
+        for (size_t j = i; j < std::min(requests, i + batch_size); ++j) {
+            batches.back()->Add(food[j]);
+        }
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    size_t answered = 0;
+    for (const std::string &f : food) {
+        answered += !chain[0]->Handle(f).empty();
+    }
+    double single_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+    // One untimed pass, so both batched runs below find their answer buffers allocated
+    for (ChainPipeline::Batch &batch : batches) {
+        chain[0]->HandleBatch(*batch);
+        batch->Rewind();
+    }
+    begin = std::chrono::steady_clock::now();
+    for (ChainPipeline::Batch &batch : batches) {
+        chain[0]->HandleBatch(*batch);
+    }
+    double batched_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+    for (ChainPipeline::Batch &batch : batches) {
+        batch->Rewind();
+    }
+    ChainPipeline pipeline(*chain[0]);
+    begin = std::chrono::steady_clock::now();
+    std::thread collector([&] {
+        size_t index = 0;
+        while (ChainPipeline::Batch batch = pipeline.Receive()) {
+            batches[index++] = std::move(batch);
+        }
+    });
+    size_t count = batches.size();
+    for (size_t i = 0; i < count; ++i) {
+        pipeline.Submit(std::move(batches[i]));
+    }
+    pipeline.Close();
+    collector.join();
+    double pipelined_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+    size_t pipelined_answered = 0;
+    for (const ChainPipeline::Batch &batch : batches) {
+        pipelined_answered += batch->requests_.size() - batch->pending_.size();
+    }
+
+    std::cout << "\n" << requests << " requests through " << handlers << " handlers, batches of " << batch_size << ":\n"
+              << "  one request at a time: " << single_ms << " ms\n"
+              << "  HandleBatch:           " << batched_ms << " ms\n"
+              << "  pipeline, " << handlers << " stages:  " << pipelined_ms << " ms (" << std::thread::hardware_concurrency()
+              << " hardware thread(s)), same answers: " << std::boolalpha << (answered == pipelined_answered) << "\n";
+    std::vector<StageStats> stats = pipeline.Stats();
+    for (size_t i = 0; i < stats.size(); ++i) {
+        std::cout << "  stage " << i << ": " << stats[i].batches_ << " batches, " << stats[i].requests_ << " requests, hit rate "
+                  << stats[i].hit_rate() * 100 << "%, " << stats[i].throughput() / 1e6 << " M requests/s\n";
+    }
+}
+
+/**
+ * The other part of the client code constructs the actual chain.
+ */
+int main() {
+    MonkeyHandler monkey;
+    SquirrelHandler squirrel;
+    DogHandler dog;
+    monkey.SetNext(&squirrel)->SetNext(&dog);
+
+    /**
+     * The client should be able to send a request to any handler, not just the
+     * first one in the chain.
+     */
+    std::cout << "Chain: Monkey > Squirrel > Dog\n\n";
+    ClientCode(monkey);
+    std::cout << "\n";
+    std::cout << "Subchain: Squirrel > Dog\n\n";
+    ClientCode(squirrel);
+
+    Benchmark();
+    return 0;
+}
@@ -0,0 +1,334 @@
+/**
+ * State machines without an allocation per transition.
+ *
+ * State.cpp deletes the old state and news up the next one on every
+ * transition, and prints the state's typeid name while doing so. Here are two
+ * ways to keep the same machine at the cost of one indexed jump per request:
+ *
+ * - PreallocatedContext keeps the State classes, but owns one instance of each
+ *   for its whole life. TransitionTo() only moves a pointer.
+ * - TableContext drops the classes altogether. States and requests are enums,
+ *   and a constexpr table says, for every state and request, which handler to
+ *   call and which state comes next.
+ *
+ * Tracing of transitions is compiled in only with -DSTATE_TRACE=1.
+ */
+#include <iostream>
+#include <string_view>
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#ifndef STATE_TRACE
+#define STATE_TRACE 0
+#endif
+
+// Counts heap allocations so the benchmark can show what preallocation saves.
+#include "../../Common/HeapAllocations.h"
+
+/**
+ * The states and requests every variant below knows about.
+ */
+enum class StateId : uint8_t { A, B, Count };
+enum class RequestId : uint8_t { Request1, Request2, Count };
+
+constexpr size_t kStateCount = static_cast<size_t>(StateId::Count);
+constexpr size_t kRequestCount = static_cast<size_t>(RequestId::Count);
+
+constexpr std::array<std::string_view, kStateCount> kStateNames = {"ConcreteStateA", "ConcreteStateB"};
+
+constexpr std::string_view StateName(StateId id) {
+    return kStateNames[static_cast<size_t>(id)];
+}
+
+/**
+ * Where the handlers report what they do. Null in the benchmark, so the
+ * comparison is about transitions and not about printing.
+ */
+static std::ostream *g_Log = &std::cout;
+
+void Say(std::string_view line) {
+    if (g_Log != nullptr) {
+        *g_Log << line << "\n";
+    }
+}
+
+/**
+ * The State classes of State.cpp, except that a transition names the next
+ * state instead of allocating it.
+ */
+class PreallocatedContext;
+
+class State {
+protected:
+    PreallocatedContext *context_;
+
+public:
+    virtual ~State() {}
+
+    void set_context(PreallocatedContext *context) {
+        this->context_ = context;
+    }
+
+    virtual void Handle1() = 0;
+    virtual void Handle2() = 0;
+};
+
+class ConcreteStateA : public State {
+public:
+    void Handle1() override;
+    void Handle2() override {
+        Say("ConcreteStateA handles request2.");
+    }
+};
+
+class ConcreteStateB : public State {
+public:
+    void Handle1() override {
+        Say("ConcreteStateB handles request1.");
+    }
+    void Handle2() override;
+};
+
+/**
+ * The Context holds every state object it can be in. They are created with
+ * the context and each gets its backreference once, so a transition is a
+ * pointer assignment.
+ */
+class PreallocatedContext {
+private:
+    ConcreteStateA state_a_;
+    ConcreteStateB state_b_;
+    std::array<State *, kStateCount> states_;
+    State *state_;
+    StateId id_;
+
+public:
+    explicit PreallocatedContext(StateId initial) : states_{&state_a_, &state_b_}, state_(nullptr) {
+        for (State *state : this->states_) {
+            state->set_context(this);
+        }
+        this->TransitionTo(initial);
+    }
+
+    PreallocatedContext(const PreallocatedContext &) = delete;
+    PreallocatedContext &operator=(const PreallocatedContext &) = delete;
+
+    void TransitionTo(StateId id) {
+#if STATE_TRACE
+        std::cout << "Transition to " << StateName(id) << ".\n";
+#endif
+        this->id_ = id;
+        this->state_ = this->states_[static_cast<size_t>(id)];
+    }
+
+    StateId state() const {
+        return this->id_;
+    }
+
+    void Request1() {
+        this->state_->Handle1();
+    }
+    void Request2() {
+        this->state_->Handle2();
+    }
+};
+
+void ConcreteStateA::Handle1() {
+    Say("ConcreteStateA handles request1.");
+    Say("ConcreteStateA wants to change the state of the context.");
+    this->context_->TransitionTo(StateId::B);
+}
+
+void ConcreteStateB::Handle2() {
+    Say("ConcreteStateB handles request2.");
+    Say("ConcreteStateB wants to change the state of the context.");
+    this->context_->TransitionTo(StateId::A);
+}
+
+/**
+ * The table-driven machine. A row per state, a column per request; each cell
+ * has the handler to run and the state to move to afterwards.
+ */
+struct Transition {
+    void (*handle_)();
+    StateId next_;
+};
+
+namespace Handlers {
+void A1() {
+    Say("ConcreteStateA handles request1.");
+    Say("ConcreteStateA wants to change the state of the context.");
+}
+void A2() {
+    Say("ConcreteStateA handles request2.");
+}
+void B1() {
+    Say("ConcreteStateB handles request1.");
+}
+void B2() {
+    Say("ConcreteStateB handles request2.");
+    Say("ConcreteStateB wants to change the state of the context.");
+}
+}
+
+constexpr Transition kTransitions[kStateCount][kRequestCount] = {
+    /* A */ {{Handlers::A1, StateId::B}, {Handlers::A2, StateId::A}},
+    /* B */ {{Handlers::B1, StateId::B}, {Handlers::B2, StateId::A}},
+};
+
+static_assert(kTransitions[static_cast<size_t>(StateId::A)][static_cast<size_t>(RequestId::Request1)].next_ == StateId::B,
+              "the table is checked at compile time");
+
+/**
+ * The Context is just the current state. It is trivially copyable and a
+ * request is a table lookup and a call.
+ */
+class TableContext {
+private:
+    StateId state_;
+
+public:
+    explicit TableContext(StateId initial) : state_(initial) {}
+
+    void Handle(RequestId request) {
+        const Transition &t = kTransitions[static_cast<size_t>(this->state_)][static_cast<size_t>(request)];
+        t.handle_();
+#if STATE_TRACE
+        if (t.next_ != this->state_) {
+            std::cout << "Transition to " << StateName(t.next_) << ".\n";
+        }
+#endif
+        this->state_ = t.next_;
+    }
+
+    StateId state() const {
+        return this->state_;
+    }
+
+    void Request1() {
+        this->Handle(RequestId::Request1);
+    }
+    void Request2() {
+        this->Handle(RequestId::Request2);
+    }
+};
+
+/**
+ * State.cpp's way of changing state, for the benchmark: a new state object
+ * per transition.
+ */
+class HeapContext;
+
+class HeapState {
+protected:
+    HeapContext *context_;
+public:
+    virtual ~HeapState() {}
+    void set_context(HeapContext *context) {
+        this->context_ = context;
+    }
+    virtual void Handle1() = 0;
+    virtual void Handle2() = 0;
+};
+
+class HeapContext {
+private:
+    HeapState *state_;
+public:
+    explicit HeapContext(HeapState *state) : state_(nullptr) {
+        this->TransitionTo(state);
+    }
+    ~HeapContext() {
+        delete state_;
+    }
+    void TransitionTo(HeapState *state) {
+        if (this->state_ != nullptr)
+            delete this->state_;
+        this->state_ = state;
+        this->state_->set_context(this);
+    }
+    void Request1() {
+        this->state_->Handle1();
+    }
+    void Request2() {
+        this->state_->Handle2();
+    }
+};
+
+class HeapStateA : public HeapState {
+public:
+    void Handle1() override;
+    void Handle2() override {
+        Say("ConcreteStateA handles request2.");
+    }
+};
+
+class HeapStateB : public HeapState {
+public:
+    void Handle1() override {
+        Say("ConcreteStateB handles request1.");
+    }
+    void Handle2() override {
+        Say("ConcreteStateB handles request2.");
+        this->context_->TransitionTo(new HeapStateA);
+    }
+};
+
+void HeapStateA::Handle1() {
+    Say("ConcreteStateA handles request1.");
+    this->context_->TransitionTo(new HeapStateB);
+}
+
+/**
+ * The client code
+ */
+template <typename ContextT>
+void ClientCode(ContextT &context) {
+    context.Request1();
+    context.Request2();
+    std::cout << "Now in " << StateName(context.state()) << ".\n";
+}
+
+/**
+ * Every request of the benchmark changes the state: Request1 in A, then
+ * Request2 in B, and so on.
+ */
+template <typename ContextT>
+double TimeRequests(ContextT &context, size_t requests, size_t &allocations) {
+    size_t before = g_HeapAllocations;
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < requests; i += 2) {
+        context.Request1();
+        context.Request2();
+    }
+    auto time = std::chrono::steady_clock::now() - begin;
+    allocations = g_HeapAllocations - before;
+    return std::chrono::duration<double, std::nano>(time).count() / requests;
+}
+
+int main() {
+    std::cout << "Preallocated states:\n";
+    PreallocatedContext preallocated(StateId::A);
+    ClientCode(preallocated);
+
+    std::cout << "\nTransition table:\n";
+    TableContext table(StateId::A);
+    ClientCode(table);
+
+    g_Log = nullptr;
+    // A traced build prints every transition, so it only runs a few
+    const size_t requests = STATE_TRACE ? 8 : 20000000;
+    size_t heap_allocations, preallocated_allocations, table_allocations;
+    HeapContext heap(new HeapStateA);
+    double heap_ns = TimeRequests(heap, requests, heap_allocations);
+    double preallocated_ns = TimeRequests(preallocated, requests, preallocated_allocations);
+    double table_ns = TimeRequests(table, requests, table_allocations);
+
+    std::cout << "\n" << requests << " requests, each one a transition:\n"
+              << "  new state per transition: " << heap_ns << " ns per request, " << heap_allocations << " allocations\n"
+              << "  preallocated states:      " << preallocated_ns << " ns per request, " << preallocated_allocations
+              << " allocations\n"
+              << "  transition table:         " << table_ns << " ns per request, " << table_allocations << " allocations\n";
+    return 0;
+}
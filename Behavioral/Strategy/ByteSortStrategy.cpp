@@ -0,0 +1,430 @@
+/**
+ * Sorting strategies for large byte buffers.
+ *
+ * ConcreteStrategyA/B from Strategy.cpp copy the input and run std::sort on
+ * it. For bytes there is a much cheaper way: there are only 256 possible
+ * values, so counting them and writing each value out as often as it occurred
+ * sorts in two linear passes. This file adds that counting sort, a version that
+ * splits both passes over several threads, and an in-place entry point that
+ * sorts a caller-owned buffer instead of returning a sorted copy. The
+ * AdaptiveContext picks a strategy from the size of the input.
+ */
+#include <string>
+#include <string_view>
+#include <iostream>
+#include <memory>
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <random>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+
+class Strategy
+{
+public:
+    virtual ~Strategy() {}
+    virtual std::string doAlgorithm(std::string_view data) const = 0;
+    /**
+     * Sorts `size` bytes at `data` where they are. By default this goes
+     * through doAlgorithm() and copies the result back; strategies that can
+     * do better override it.
+     */
+    virtual void doAlgorithmInPlace(char *data, size_t size) const {
+        std::string result = this->doAlgorithm(std::string_view(data, size));
+        std::memcpy(data, result.data(), size);
+    }
+};
+
+enum class Order { Ascending, Descending };
+
+/**
+ * The comparison based strategies of Strategy.cpp, extended to sort in place
+ * without the copy.
+ */
+class ConcreteStrategyA : public Strategy {
+public:
+    std::string doAlgorithm(std::string_view data) const override {
+        std::string result(data);
+        this->doAlgorithmInPlace(result.data(), result.size());
+
+        return result;
+    }
+    void doAlgorithmInPlace(char *data, size_t size) const override {
+        std::sort(data, data + size);
+    }
+};
+class ConcreteStrategyB : public Strategy {
+public:
+    std::string doAlgorithm(std::string_view data) const override {
+        std::string result(data);
+        this->doAlgorithmInPlace(result.data(), result.size());
+
+        return result;
+    }
+    void doAlgorithmInPlace(char *data, size_t size) const override {
+        std::sort(data, data + size, std::greater<>());
+    }
+};
+
+using Histogram = std::array<size_t, 256>;
+
+static void Count(const char *data, size_t size, Histogram &histogram) {
+    histogram.fill(0);
+    for (size_t i = 0; i < size; ++i) {
+        ++histogram[static_cast<unsigned char>(data[i])];
+    }
+}
+
+/**
+ * Calls `write(value)` for each byte value in sorted order. The order is
+ * the order of `char`, as std::sort sees it, so on platforms where char is
+ * signed the bytes 0x80..0xff come first.
+ */
+template <typename Write>
+static void ForEachValue(Order order, Write write) {
+    for (int i = 0; i <= CHAR_MAX - CHAR_MIN; ++i) {
+        int value = order == Order::Ascending ? CHAR_MIN + i : CHAR_MAX - i;
+        write(static_cast<unsigned char>(static_cast<char>(value)));
+    }
+}
+
+/**
+ * Counting sort: one pass to count each byte value, one pass to write the
+ * runs. Linear in the input and never compares two bytes.
+ */
+class CountingSortStrategy : public Strategy {
+private:
+    Order order_;
+public:
+    explicit CountingSortStrategy(Order order = Order::Ascending) : order_(order) {}
+
+    std::string doAlgorithm(std::string_view data) const override {
+        Histogram histogram;
+        Count(data.data(), data.size(), histogram);
+        std::string result(data.size(), '\0');
+        this->Fill(histogram, result.data());
+
+        return result;
+    }
+    void doAlgorithmInPlace(char *data, size_t size) const override {
+        Histogram histogram;
+        Count(data, size, histogram);
+        this->Fill(histogram, data);
+    }
+
+private:
+    void Fill(const Histogram &histogram, char *out) const {
+        ForEachValue(this->order_, [&](unsigned char value) {
+            std::memset(out, value, histogram[value]);
+            out += histogram[value];
+        });
+    }
+};
+
+/**
+ * Worker threads that live as long as their owner. Run(parts, job) calls
+ * job(part) once for every part, part 0 on the calling thread and the others
+ * on the workers, and returns when all of them are done. Calls to Run() from
+ * several threads take turns.
+ */
+class PartPool {
+public:
+    explicit PartPool(size_t workers) {
+        for (size_t i = 0; i < workers; ++i) {
+            this->workers_.emplace_back([this, i] { this->Work(i + 1); });
+        }
+    }
+    ~PartPool() {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex_);
+            this->stopping_ = true;
+            ++this->generation_;
+        }
+        this->start_.notify_all();
+        for (std::thread &worker : this->workers_) {
+            worker.join();
+        }
+    }
+
+    PartPool(const PartPool &) = delete;
+    PartPool &operator=(const PartPool &) = delete;
+
+    /**
+     * `parts` may be at most one more than the number of workers.
+     */
+    template <typename Job>
+    void Run(size_t parts, Job &job) {
+        std::lock_guard<std::mutex> turn(this->run_mutex_);
+        {
+            std::lock_guard<std::mutex> lock(this->mutex_);
+            this->invoke_ = [](void *context, size_t part) { (*static_cast<Job *>(context))(part); };
+            this->context_ = &job;
+            this->parts_ = parts;
+            this->remaining_ = parts - 1;
+            ++this->generation_;
+        }
+        this->start_.notify_all();
+        job(0);
+        std::unique_lock<std::mutex> lock(this->mutex_);
+        this->done_.wait(lock, [this] { return this->remaining_ == 0; });
+    }
+
+private:
+    void Work(size_t part) {
+        size_t seen = 0;
+        std::unique_lock<std::mutex> lock(this->mutex_);
+        for (;;) {
+            this->start_.wait(lock, [&] { return this->generation_ != seen; });
+            seen = this->generation_;
+            if (this->stopping_) {
+                return;
+            }
+            if (part >= this->parts_) {
+                continue;
+            }
+            void (*invoke)(void *, size_t) = this->invoke_;
+            void *context = this->context_;
+            lock.unlock();
+            invoke(context, part);
+            lock.lock();
+            if (--this->remaining_ == 0) {
+                this->done_.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex run_mutex_;
+    std::mutex mutex_;
+    std::condition_variable start_;
+    std::condition_variable done_;
+    void (*invoke_)(void *, size_t) = nullptr;
+    void *context_ = nullptr;
+    size_t parts_ = 0;
+    size_t remaining_ = 0;
+    size_t generation_ = 0;
+    bool stopping_ = false;
+};
+
+/**
+ * The counting sort with both passes split over `threads` threads. Each
+ * thread counts its own slice of the input; from the sum of the histograms
+ * each thread then works out which part of the output it has to write, and
+ * writes just that part. The threads are started with the strategy and wait
+ * between sorts, so a sort does not pay for creating them.
+ */
+class ParallelSortStrategy : public Strategy {
+private:
+    Order order_;
+    size_t threads_;
+    mutable PartPool pool_;
+public:
+    explicit ParallelSortStrategy(Order order = Order::Ascending, size_t threads = std::thread::hardware_concurrency())
+        : order_(order), threads_(std::max<size_t>(threads, 1)), pool_(this->threads_ - 1) {}
+
+    std::string doAlgorithm(std::string_view data) const override {
+        std::string result(data.size(), '\0');
+        this->Sort(data.data(), data.size(), result.data());
+
+        return result;
+    }
+    void doAlgorithmInPlace(char *data, size_t size) const override {
+        this->Sort(data, size, data);
+    }
+
+private:
+    /**
+     * `out` may be `in`: all reads happen in the first pass, all writes in the
+     * second.
+     */
+    void Sort(const char *in, size_t size, char *out) const {
+        size_t threads = std::min(this->threads_, std::max<size_t>(size / 4096, 1));
+        std::vector<Histogram> histograms(threads);
+        auto count = [&](size_t part) {
+            size_t begin = size * part / threads, end = size * (part + 1) / threads;
+            Count(in + begin, end - begin, histograms[part]);
+        };
+        this->RunParts(threads, count);
+        Histogram total{};
+        for (const Histogram &h : histograms) {
+            for (size_t v = 0; v < total.size(); ++v) {
+                total[v] += h[v];
+            }
+        }
+        auto write = [&](size_t part) {
+            // This part's window of the sorted output; write the runs that overlap it
+            size_t begin = size * part / threads, end = size * (part + 1) / threads, offset = 0;
+            ForEachValue(this->order_, [&](unsigned char value) {
+                size_t from = std::max(offset, begin), to = std::min(offset + total[value], end);
+                if (from < to) {
+                    std::memset(out + from, value, to - from);
+                }
+                offset += total[value];
+            });
+        };
+        this->RunParts(threads, write);
+    }
+
+    template <typename Job>
+    void RunParts(size_t threads, Job &job) const {
+        if (threads == 1) {
+            job(0);
+            return;
+        }
+        this->pool_.Run(threads, job);
+    }
+};
+
+/**
+ * The Context defines the interface of interest to clients.
+ */
+class Context
+{
+private:
+    std::unique_ptr<Strategy> strategy_;
+public:
+    explicit Context(std::unique_ptr<Strategy> &&strategy = {}) : strategy_(std::move(strategy)) {}
+
+    void set_strategy(std::unique_ptr<Strategy>&& strategy) {
+        strategy_ = std::move(strategy);
+    }
+    void doSomeBusinessLogic() const {
+        if (strategy_) {
+            std::cout << "Context: Sorting data using the strategy (not sure how it'll do it)\n";
+            std::string result = strategy_->doAlgorithm("aecbd");
+            std::cout << result << "\n";
+        } else {
+            std::cout << "Context: No strategy set\n";
+        }
+    }
+};
+
+/**
+ * A Context that chooses the strategy itself, from the size of the input:
+ * std::sort for a handful of bytes, where setting up 256 counters costs more
+ * than it saves, the counting sort in between, and the parallel counting sort
+ * once the input is big enough to pay for starting threads.
+ */
+class AdaptiveContext
+{
+private:
+    ConcreteStrategyA small_;
+    CountingSortStrategy medium_;
+    ParallelSortStrategy large_;
+public:
+    static constexpr size_t kCountingFrom = 256;
+    static constexpr size_t kParallelFrom = 4 << 20;
+
+    const Strategy &Pick(size_t size) const {
+        if (size < kCountingFrom) {
+            return this->small_;
+        }
+        if (size < kParallelFrom) {
+            return this->medium_;
+        }
+        return this->large_;
+    }
+
+    std::string Sort(std::string_view data) const {
+        return this->Pick(data.size()).doAlgorithm(data);
+    }
+    void SortInPlace(char *data, size_t size) const {
+        this->Pick(size).doAlgorithmInPlace(data, size);
+    }
+};
+
+void ClientCode() {
+    Context context(std::make_unique<ConcreteStrategyA>());
+    std::cout << "Client: Strategy is set to normal sorting.\n";
+    context.doSomeBusinessLogic();
+    std::cout << "\n";
+    std::cout << "Client: Strategy is set to counting sort.\n";
+    context.set_strategy(std::make_unique<CountingSortStrategy>());
+    context.doSomeBusinessLogic();
+    std::cout << "\n";
+    std::cout << "Client: Strategy is set to parallel reverse counting sort.\n";
+    context.set_strategy(std::make_unique<ParallelSortStrategy>(Order::Descending));
+    context.doSomeBusinessLogic();
+    std::cout << "\n";
+
+    std::cout << "Client: Sorting in place, strategy picked by size.\n";
+    AdaptiveContext adaptive;
+    char buffer[] = "aecbd";
+    adaptive.SortInPlace(buffer, std::strlen(buffer));
+    std::cout << buffer << "\n";
+}
+
+/**
+ * Nanoseconds per byte for sorting `size` bytes in place. The buffer is
+ * refilled from `input` before each run; the time for that is measured on its
+ * own and taken out again.
+ */
+double TimeInPlace(const Strategy &strategy, const std::string &input, size_t size, std::string &buffer) {
+    size_t runs = std::max<size_t>((16 << 20) / size, 1);
+    runs = std::min<size_t>(runs, 100000);
+    buffer.resize(size);
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < runs; ++r) {
+        std::memcpy(buffer.data(), input.data(), size);
+        strategy.doAlgorithmInPlace(buffer.data(), size);
+    }
+    auto sorting = std::chrono::steady_clock::now() - begin;
+    begin = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < runs; ++r) {
+        std::memcpy(buffer.data(), input.data(), size);
+        asm volatile("" : : "r"(buffer.data()) : "memory");
+    }
+    auto copying = std::chrono::steady_clock::now() - begin;
+    return std::max(0.0, std::chrono::duration<double, std::nano>(sorting - copying).count()) / runs / size;
+}
+
+/**
+ * The benchmark sweeps sizes from 16 bytes up to the size given on the command
+ * line, 64 MiB by default. Pass 1073741824 to go up to 1 GiB, which needs
+ * about 3 GiB of memory.
+ */
+int main(int argc, char *argv[]) {
+    ClientCode();
+
+    size_t max_size = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 64 << 20;
+    std::mt19937_64 random(1);
+    std::string input(max_size, '\0');
+    for (char &c : input) {
+        c = static_cast<char>(random());
+    }
+
+    ConcreteStrategyA comparison;
+    CountingSortStrategy counting;
+    ParallelSortStrategy parallel;
+    AdaptiveContext adaptive;
+    std::string buffer, expected;
+
+    std::cout << "\nIn-place sort of random bytes, ns per byte (" << std::thread::hardware_concurrency()
+              << " hardware thread(s)):\n"
+              << "        size   std::sort    counting    parallel  adaptive picks\n";
+    for (size_t size = std::min<size_t>(16, max_size); size > 0; size = size == max_size ? 0 : std::min(size * 16, max_size)) {
+        std::string_view data(input.data(), size);
+        // All strategies must agree with std::sort before they are timed
+        expected = comparison.doAlgorithm(data);
+        bool same = counting.doAlgorithm(data) == expected && parallel.doAlgorithm(data) == expected &&
+                    adaptive.Sort(data) == expected;
+        if (!same) {
+            std::cout << "strategies disagree at " << size << " bytes\n";
+            return 1;
+        }
+        const Strategy &picked = adaptive.Pick(size);
+        const char *name = &picked == &adaptive.Pick(0) ? "std::sort" :
+                           &picked == &adaptive.Pick(AdaptiveContext::kCountingFrom) ? "counting" : "parallel";
+
+        std::printf("%12zu %11.3f %11.3f %11.3f  %s\n", size, TimeInPlace(comparison, input, size, buffer),
+                    TimeInPlace(counting, input, size, buffer), TimeInPlace(parallel, input, size, buffer), name);
+    }
+    return 0;
+}
@@ -0,0 +1,359 @@
+/**
+ * Type-bucketed batch visitation.
+ *
+ * The classic Accept/Visit pair is kept, but instead of walking a mixed list
+ * and jumping between ConcreteComponentA and ConcreteComponentB code on every
+ * element, a VisitorBatch sorts the components into one bucket per concrete
+ * type once. Each visit then hands every bucket to the visitor in a single
+ * VisitAll call. A visitor can override VisitAll with a tight loop; one that
+ * doesn't gets the default VisitAll, which just calls its per-element method.
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <cstddef>
+
+class ConcreteComponentA;
+class ConcreteComponentB;
+
+/**
+ * A minimal read-only view of a contiguous range.
+ */
+template <typename T>
+class Span
+{
+public:
+    Span(const T *data, size_t size) : data_(data), size_(size) {}
+    Span(const std::vector<T> &v) : data_(v.data()), size_(v.size()) {}
+    const T *begin() const
+    {
+        return data_;
+    }
+    const T *end() const
+    {
+        return data_ + size_;
+    }
+    size_t size() const
+    {
+        return size_;
+    }
+    const T &operator[](size_t i) const
+    {
+        return data_[i];
+    }
+
+private:
+    const T *data_;
+    size_t size_;
+};
+
+class Visitor
+{
+public:
+    virtual ~Visitor() {}
+    virtual void VisitConcreteComponentA(const ConcreteComponentA *element) const = 0;
+    virtual void VisitConcreteComponentB(const ConcreteComponentB *element) const = 0;
+
+    /**
+     * Batch entry points. The defaults fall back to the per-element methods,
+     * so every existing visitor works with VisitorBatch unchanged.
+     */
+    virtual void VisitAll(Span<const ConcreteComponentA *> elements) const
+    {
+        for (const ConcreteComponentA *element : elements)
+        {
+            this->VisitConcreteComponentA(element);
+        }
+    }
+    virtual void VisitAll(Span<const ConcreteComponentB *> elements) const
+    {
+        for (const ConcreteComponentB *element : elements)
+        {
+            this->VisitConcreteComponentB(element);
+        }
+    }
+};
+
+/**
+ * The Component interface declares an `accept` method that should take the base
+ * visitor interface as an argument.
+ */
+class Component
+{
+public:
+    virtual ~Component() {}
+    virtual void Accept(Visitor *visitor) const = 0;
+};
+
+class ConcreteComponentA : public Component
+{
+private:
+    int value_;
+
+public:
+    explicit ConcreteComponentA(int value = 0) : value_(value) {}
+    void Accept(Visitor *visitor) const override
+    {
+        visitor->VisitConcreteComponentA(this);
+    }
+    std::string ExclusiveMethodOfConcreteComponentA() const
+    {
+        return "A";
+    }
+    int value() const
+    {
+        return value_;
+    }
+};
+
+class ConcreteComponentB : public Component
+{
+private:
+    int value_;
+
+public:
+    explicit ConcreteComponentB(int value = 0) : value_(value) {}
+    void Accept(Visitor *visitor) const override
+    {
+        visitor->VisitConcreteComponentB(this);
+    }
+    std::string SpecialMethodOfConcreteComponentB() const
+    {
+        return "B";
+    }
+    int value() const
+    {
+        return value_;
+    }
+};
+
+/**
+ * Partitions a mixed set of components by concrete type. Partitioning costs
+ * one ordinary Accept per element and is done once; every later visit is one
+ * VisitAll call per type. Elements of the same type keep their relative
+ * order, but all A's are visited before all B's.
+ */
+class VisitorBatch
+{
+public:
+    explicit VisitorBatch(const std::vector<const Component *> &components)
+    {
+        Partitioner partitioner(*this);
+        for (const Component *component : components)
+        {
+            component->Accept(&partitioner);
+        }
+    }
+
+    void Accept(const Visitor &visitor) const
+    {
+        visitor.VisitAll(Span<const ConcreteComponentA *>(a_));
+        visitor.VisitAll(Span<const ConcreteComponentB *>(b_));
+    }
+
+private:
+    class Partitioner : public Visitor
+    {
+    public:
+        explicit Partitioner(VisitorBatch &batch) : batch_(batch) {}
+        void VisitConcreteComponentA(const ConcreteComponentA *element) const override
+        {
+            batch_.a_.push_back(element);
+        }
+        void VisitConcreteComponentB(const ConcreteComponentB *element) const override
+        {
+            batch_.b_.push_back(element);
+        }
+
+    private:
+        VisitorBatch &batch_;
+    };
+
+    std::vector<const ConcreteComponentA *> a_;
+    std::vector<const ConcreteComponentB *> b_;
+};
+
+/**
+ * ConcreteVisitor1 provides batch overrides. They print the same lines as
+ * visiting one element at a time, but build them into one buffer and write
+ * it to std::cout once per batch.
+ */
+class ConcreteVisitor1 : public Visitor
+{
+public:
+    using Visitor::VisitAll;
+
+    void VisitConcreteComponentA(const ConcreteComponentA *element) const override
+    {
+        std::cout << element->ExclusiveMethodOfConcreteComponentA() << " + ConcreteVisitor1\n";
+    }
+    void VisitConcreteComponentB(const ConcreteComponentB *element) const override
+    {
+        std::cout << element->SpecialMethodOfConcreteComponentB() << " + ConcreteVisitor1\n";
+    }
+    void VisitAll(Span<const ConcreteComponentA *> elements) const override
+    {
+        std::string out;
+        for (const ConcreteComponentA *element : elements)
+        {
+            out += element->ExclusiveMethodOfConcreteComponentA();
+            out += " + ConcreteVisitor1\n";
+        }
+        std::cout << out;
+    }
+    void VisitAll(Span<const ConcreteComponentB *> elements) const override
+    {
+        std::string out;
+        for (const ConcreteComponentB *element : elements)
+        {
+            out += element->SpecialMethodOfConcreteComponentB();
+            out += " + ConcreteVisitor1\n";
+        }
+        std::cout << out;
+    }
+};
+
+/**
+ * ConcreteVisitor2 only knows the per-element methods and relies on the
+ * default batch fallback.
+ */
+class ConcreteVisitor2 : public Visitor
+{
+public:
+    void VisitConcreteComponentA(const ConcreteComponentA *element) const override
+    {
+        std::cout << element->ExclusiveMethodOfConcreteComponentA() << " + ConcreteVisitor2\n";
+    }
+    void VisitConcreteComponentB(const ConcreteComponentB *element) const override
+    {
+        std::cout << element->SpecialMethodOfConcreteComponentB() << " + ConcreteVisitor2\n";
+    }
+};
+
+/**
+ * Benchmark visitors: the same arithmetic, with and without batch overrides.
+ */
+class ChecksumVisitor : public Visitor
+{
+public:
+    void VisitConcreteComponentA(const ConcreteComponentA *element) const override
+    {
+        sum_a_ += element->value();
+    }
+    void VisitConcreteComponentB(const ConcreteComponentB *element) const override
+    {
+        sum_b_ += static_cast<int64_t>(element->value()) * 31;
+    }
+    bool operator==(const ChecksumVisitor &other) const
+    {
+        return sum_a_ == other.sum_a_ && sum_b_ == other.sum_b_;
+    }
+    mutable int64_t sum_a_ = 0;
+    mutable int64_t sum_b_ = 0;
+};
+
+class BatchChecksumVisitor : public ChecksumVisitor
+{
+public:
+    using ChecksumVisitor::VisitAll;
+
+    /**
+     * The loop bodies are non-virtual and branch-free, so the compiler can
+     * unroll them and keep the accumulator in a register.
+     */
+    void VisitAll(Span<const ConcreteComponentA *> elements) const override
+    {
+        int64_t sum = 0;
+        for (const ConcreteComponentA *element : elements)
+        {
+            sum += element->value();
+        }
+        sum_a_ += sum;
+    }
+    void VisitAll(Span<const ConcreteComponentB *> elements) const override
+    {
+        int64_t sum = 0;
+        for (const ConcreteComponentB *element : elements)
+        {
+            sum += element->value();
+        }
+        sum_b_ += sum * 31;
+    }
+};
+
+/**
+ * The client code can run visitor operations over any set of elements without
+ * figuring out their concrete classes. The accept operation directs a call to
+ * the appropriate operation in the visitor object.
+ */
+void ClientCode(const std::vector<const Component *> &components, Visitor *visitor)
+{
+    for (const Component *comp : components)
+    {
+        comp->Accept(visitor);
+    }
+}
+
+template <typename F>
+double NanosecondsPerElement(size_t elements, int rounds, F f)
+{
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i)
+    {
+        f();
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin);
+    return elapsed.count() / (static_cast<double>(elements) * rounds);
+}
+
+int main()
+{
+    ConcreteComponentA a1, a2;
+    ConcreteComponentB b1;
+    std::vector<const Component *> components = {&a1, &b1, &a2};
+    VisitorBatch batch(components);
+    std::cout << "A visitor with batch overrides gets one call per type, and prints what Visit would:\n";
+    batch.Accept(ConcreteVisitor1());
+    std::cout << "\nA per-element visitor still works through the fallback:\n";
+    batch.Accept(ConcreteVisitor2());
+
+    const size_t elements = 1000000;
+    const int rounds = 20;
+    std::mt19937 random(42);
+    std::vector<std::unique_ptr<Component>> owned;
+    std::vector<const Component *> mixed;
+    for (size_t i = 0; i < elements; ++i)
+    {
+        int value = static_cast<int>(random() % 1000);
+        if (random() % 2)
+        {
+            owned.push_back(std::make_unique<ConcreteComponentA>(value));
+        }
+        else
+        {
+            owned.push_back(std::make_unique<ConcreteComponentB>(value));
+        }
+        mixed.push_back(owned.back().get());
+    }
+    VisitorBatch big(mixed);
+
+    ChecksumVisitor per_element, fallback;
+    BatchChecksumVisitor batched;
+    double per_element_ns = NanosecondsPerElement(elements, rounds, [&]
+                                                  { ClientCode(mixed, &per_element); });
+    double fallback_ns = NanosecondsPerElement(elements, rounds, [&]
+                                               { big.Accept(fallback); });
+    double batched_ns = NanosecondsPerElement(elements, rounds, [&]
+                                              { big.Accept(batched); });
+
+    std::cout << "\nVisiting " << elements << " mixed components, ns per element:\n"
+              << "  ClientCode, mixed order:           " << per_element_ns << "\n"
+              << "  VisitorBatch, per-element visitor: " << fallback_ns << "\n"
+              << "  VisitorBatch, batch overrides:     " << batched_ns << "\n"
+              << "Checksums agree: " << std::boolalpha << (per_element == fallback && per_element == batched) << "\n";
+    return 0;
+}
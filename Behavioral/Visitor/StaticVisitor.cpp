@@ -0,0 +1,289 @@
+/**
+ * Statically dispatched Visitor.
+ *
+ * The classic double dispatch costs two virtual calls per element and keeps
+ * every element in its own heap allocation. When the set of component classes
+ * is closed, the elements can instead be stored by value in a contiguous
+ * std::vector<std::variant<...>> and visited with std::visit, or grouped into
+ * one vector per type and visited with no dispatch at all. Either way the
+ * compiler sees the concrete visitor and component types and can inline the
+ * visiting methods into the loop.
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <variant>
+#include <tuple>
+#include <memory>
+#include <chrono>
+#include <random>
+#include <cstdint>
+
+class ConcreteComponentA;
+class ConcreteComponentB;
+
+class Visitor
+{
+public:
+    virtual ~Visitor() {}
+    virtual void VisitConcreteComponentA(const ConcreteComponentA *element) const = 0;
+    virtual void VisitConcreteComponentB(const ConcreteComponentB *element) const = 0;
+};
+
+/**
+ * The Component interface declares an `accept` method that should take the base
+ * visitor interface as an argument.
+ */
+class Component
+{
+public:
+    virtual ~Component() {}
+    virtual void Accept(Visitor *visitor) const = 0;
+};
+
+/**
+ * The concrete components still support the classic Accept, so the same
+ * classes can be used on both paths. They now carry a small payload so the
+ * benchmark visitors have something to compute with.
+ */
+class ConcreteComponentA : public Component
+{
+private:
+    int value_;
+
+public:
+    explicit ConcreteComponentA(int value = 0) : value_(value) {}
+    void Accept(Visitor *visitor) const override
+    {
+        visitor->VisitConcreteComponentA(this);
+    }
+    std::string ExclusiveMethodOfConcreteComponentA() const
+    {
+        return "A";
+    }
+    int value() const
+    {
+        return value_;
+    }
+};
+
+class ConcreteComponentB : public Component
+{
+private:
+    int value_;
+
+public:
+    explicit ConcreteComponentB(int value = 0) : value_(value) {}
+    void Accept(Visitor *visitor) const override
+    {
+        visitor->VisitConcreteComponentB(this);
+    }
+    std::string SpecialMethodOfConcreteComponentB() const
+    {
+        return "B";
+    }
+    int value() const
+    {
+        return value_;
+    }
+};
+
+/**
+ * The closed set of components, stored by value.
+ */
+using AnyComponent = std::variant<ConcreteComponentA, ConcreteComponentB>;
+
+/**
+ * Concrete Visitors implement several versions of the same algorithm. Marking
+ * them `final` lets the compiler turn calls through a concrete visitor
+ * reference into direct (and inlinable) calls.
+ */
+class ConcreteVisitor1 final : public Visitor
+{
+public:
+    void VisitConcreteComponentA(const ConcreteComponentA *element) const override
+    {
+        std::cout << element->ExclusiveMethodOfConcreteComponentA() << " + ConcreteVisitor1\n";
+    }
+    void VisitConcreteComponentB(const ConcreteComponentB *element) const override
+    {
+        std::cout << element->SpecialMethodOfConcreteComponentB() << " + ConcreteVisitor1\n";
+    }
+};
+
+class ConcreteVisitor2 final : public Visitor
+{
+public:
+    void VisitConcreteComponentA(const ConcreteComponentA *element) const override
+    {
+        std::cout << element->ExclusiveMethodOfConcreteComponentA() << " + ConcreteVisitor2\n";
+    }
+    void VisitConcreteComponentB(const ConcreteComponentB *element) const override
+    {
+        std::cout << element->SpecialMethodOfConcreteComponentB() << " + ConcreteVisitor2\n";
+    }
+};
+
+/**
+ * A visitor doing real work per element, used by the benchmark.
+ */
+class ChecksumVisitor final : public Visitor
+{
+public:
+    void VisitConcreteComponentA(const ConcreteComponentA *element) const override
+    {
+        sum_a_ += element->value();
+    }
+    void VisitConcreteComponentB(const ConcreteComponentB *element) const override
+    {
+        sum_b_ += static_cast<int64_t>(element->value()) * 31;
+    }
+    bool operator==(const ChecksumVisitor &other) const
+    {
+        return sum_a_ == other.sum_a_ && sum_b_ == other.sum_b_;
+    }
+    mutable int64_t sum_a_ = 0;
+    mutable int64_t sum_b_ = 0;
+};
+
+/**
+ * Adapts any visitor with the classic Visit* methods to the overload set
+ * std::visit expects. `V` is the concrete visitor type, so the calls are
+ * static.
+ */
+template <typename V>
+struct StaticVisit
+{
+    const V &visitor_;
+
+    void operator()(const ConcreteComponentA &element) const
+    {
+        visitor_.VisitConcreteComponentA(&element);
+    }
+    void operator()(const ConcreteComponentB &element) const
+    {
+        visitor_.VisitConcreteComponentB(&element);
+    }
+};
+
+/**
+ * Components grouped by type: one contiguous array per class, so visiting is
+ * a plain loop per array with no per-element dispatch.
+ */
+class ComponentStore
+{
+public:
+    void Add(const AnyComponent &component)
+    {
+        std::visit([this](const auto &c)
+                   { std::get<std::vector<std::decay_t<decltype(c)>>>(this->groups_).push_back(c); },
+                   component);
+    }
+
+    template <typename V>
+    void VisitAll(const V &visitor) const
+    {
+        for (const ConcreteComponentA &a : std::get<std::vector<ConcreteComponentA>>(groups_))
+        {
+            visitor.VisitConcreteComponentA(&a);
+        }
+        for (const ConcreteComponentB &b : std::get<std::vector<ConcreteComponentB>>(groups_))
+        {
+            visitor.VisitConcreteComponentB(&b);
+        }
+    }
+
+private:
+    std::tuple<std::vector<ConcreteComponentA>, std::vector<ConcreteComponentB>> groups_;
+};
+
+/**
+ * The client code can run visitor operations over any set of elements without
+ * figuring out their concrete classes. The accept operation directs a call to
+ * the appropriate operation in the visitor object.
+ */
+void ClientCode(const std::vector<const Component *> &components, Visitor *visitor)
+{
+    for (const Component *comp : components)
+    {
+        comp->Accept(visitor);
+    }
+}
+
+/**
+ * The statically dispatched counterpart: the visitor type is a template
+ * parameter and the elements are held by value.
+ */
+template <typename V>
+void StaticClientCode(const std::vector<AnyComponent> &components, const V &visitor)
+{
+    StaticVisit<V> visit{visitor};
+    for (const AnyComponent &comp : components)
+    {
+        std::visit(visit, comp);
+    }
+}
+
+template <typename F>
+double NanosecondsPerElement(size_t elements, int rounds, F f)
+{
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i)
+    {
+        f();
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin);
+    return elapsed.count() / (static_cast<double>(elements) * rounds);
+}
+
+int main()
+{
+    std::vector<AnyComponent> components = {ConcreteComponentA(), ConcreteComponentB()};
+    std::cout << "The client code works with all visitors through std::visit:\n";
+    ConcreteVisitor1 visitor1;
+    StaticClientCode(components, visitor1);
+    std::cout << "\n";
+    std::cout << "It allows the same client code to work with different types of visitors:\n";
+    ConcreteVisitor2 visitor2;
+    StaticClientCode(components, visitor2);
+
+    const size_t elements = 1000000;
+    const int rounds = 20;
+    std::mt19937 random(42);
+    std::vector<std::unique_ptr<Component>> owned;
+    std::vector<const Component *> pointers;
+    std::vector<AnyComponent> values;
+    ComponentStore grouped;
+    values.reserve(elements);
+    for (size_t i = 0; i < elements; ++i)
+    {
+        int value = static_cast<int>(random() % 1000);
+        if (random() % 2)
+        {
+            owned.push_back(std::make_unique<ConcreteComponentA>(value));
+            values.emplace_back(ConcreteComponentA(value));
+        }
+        else
+        {
+            owned.push_back(std::make_unique<ConcreteComponentB>(value));
+            values.emplace_back(ConcreteComponentB(value));
+        }
+        pointers.push_back(owned.back().get());
+        grouped.Add(values.back());
+    }
+
+    ChecksumVisitor dynamic_visitor, variant_visitor, grouped_visitor;
+    double dynamic_ns = NanosecondsPerElement(elements, rounds, [&]
+                                              { ClientCode(pointers, &dynamic_visitor); });
+    double variant_ns = NanosecondsPerElement(elements, rounds, [&]
+                                              { StaticClientCode(values, variant_visitor); });
+    double grouped_ns = NanosecondsPerElement(elements, rounds, [&]
+                                              { grouped.VisitAll(grouped_visitor); });
+
+    std::cout << "\nVisiting " << elements << " mixed components, ns per element:\n"
+              << "  double dispatch (ClientCode):   " << dynamic_ns << "\n"
+              << "  std::visit over variant vector: " << variant_ns << "\n"
+              << "  grouped by type:                " << grouped_ns << "\n"
+              << "Checksums agree: " << std::boolalpha << (dynamic_visitor == variant_visitor && dynamic_visitor == grouped_visitor) << "\n";
+    return 0;
+}
@@ -0,0 +1,38 @@
+/**
+ * AbstractFactory.cpp: making one product of each kind and deleting them, and
+ * a product collaborating with the other. The baseline of
+ * ArenaFactoryBench.cpp.
+ */
+#define main AbstractFactoryDemo
+#include "Creational/AbstractFactory/AbstractFactory.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+BENCHMARK("CreateProductA+CreateProductB+delete") {
+    ConcreteFactory1 factory;
+    state.Measure([&] {
+        const AbstractProductA *product_a = factory.CreateProductA();
+        const AbstractProductB *product_b = factory.CreateProductB();
+        bench::DoNotOptimize(product_a);
+        bench::DoNotOptimize(product_b);
+        delete product_a;
+        delete product_b;
+    });
+}
+
+BENCHMARK("AbstractProductB::AnotherUsefulFunctionB") {
+    ConcreteFactory1 factory;
+    const AbstractProductA *product_a = factory.CreateProductA();
+    const AbstractProductB *product_b = factory.CreateProductB();
+    state.Measure([&] {
+        std::string result = product_b->AnotherUsefulFunctionB(*product_a);
+        bench::DoNotOptimize(result.data());
+    });
+    delete product_a;
+    delete product_b;
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "AbstractFactory/AbstractFactory");
+}
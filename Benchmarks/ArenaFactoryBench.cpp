@@ -0,0 +1,100 @@
+/**
+ * ArenaFactory.cpp: the cases of AbstractFactoryBench.cpp, then a family made
+ * as one block, on the default heap and on a pool, and 1000 families made at
+ * once. The last cases visit 100000 pairs in random order, made one product
+ * at a time and made as one batch.
+ */
+#define main ArenaFactoryDemo
+#include "Creational/AbstractFactory/ArenaFactory.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+BENCHMARK("CreateProductA+CreateProductB+delete") {
+    ConcreteFactory1 factory;
+    state.Measure([&] {
+        const AbstractProductA *product_a = factory.CreateProductA();
+        const AbstractProductB *product_b = factory.CreateProductB();
+        bench::DoNotOptimize(product_a);
+        bench::DoNotOptimize(product_b);
+        delete product_a;
+        delete product_b;
+    });
+}
+
+BENCHMARK("AbstractProductB::AnotherUsefulFunctionB") {
+    ConcreteFactory1 factory;
+    ProductFamilies family = factory.CreateFamily();
+    state.Measure([&] {
+        std::string result = family.B(0).AnotherUsefulFunctionB(family.A(0));
+        bench::DoNotOptimize(result.data());
+    });
+}
+
+void CreateFamily(bench::State &state, const AbstractFactory &factory) {
+    state.Measure([&] {
+        ProductFamilies family = factory.CreateFamily();
+        bench::DoNotOptimize(&family.A(0));
+    });
+}
+
+BENCHMARK("AbstractFactory::CreateFamily") {
+    CreateFamily(state, ConcreteFactory1());
+}
+
+BENCHMARK("AbstractFactory::CreateFamily/pool") {
+    std::pmr::unsynchronized_pool_resource pool;
+    CreateFamily(state, ConcreteFactory1(&pool));
+}
+
+BENCHMARK("AbstractFactory::CreateFamilies/1000") {
+    ConcreteFactory1 factory;
+    state.Measure([&] {
+        ProductFamilies families = factory.CreateFamilies(1000);
+        bench::DoNotOptimize(&families.A(999));
+    });
+}
+
+std::vector<size_t> Shuffled(size_t pairs) {
+    std::vector<size_t> order(pairs);
+    for (size_t i = 0; i < pairs; ++i) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937(1));
+    return order;
+}
+
+BENCHMARK("AbstractProductB::Combine/100000/single products") {
+    ConcreteFactory1 factory;
+    std::vector<size_t> order = Shuffled(100000);
+    std::vector<std::unique_ptr<AbstractProductA>> products_a;
+    std::vector<std::unique_ptr<AbstractProductB>> products_b;
+    for (size_t i = 0; i < order.size(); ++i) {
+        products_a.emplace_back(factory.CreateProductA());
+        products_b.emplace_back(factory.CreateProductB());
+    }
+    long checksum = 0;
+    state.Measure([&] {
+        for (size_t i : order) {
+            checksum += products_b[i]->Combine(*products_a[i]);
+        }
+    });
+    bench::DoNotOptimize(checksum);
+}
+
+BENCHMARK("AbstractProductB::Combine/100000/families") {
+    ConcreteFactory1 factory;
+    std::vector<size_t> order = Shuffled(100000);
+    ProductFamilies families = factory.CreateFamilies(order.size());
+    long checksum = 0;
+    state.Measure([&] {
+        for (size_t i : order) {
+            checksum += families.B(i).Combine(families.A(i));
+        }
+    });
+    bench::DoNotOptimize(checksum);
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "AbstractFactory/ArenaFactory");
+}
@@ -0,0 +1,23 @@
+/**
+ * ArenaMemento.cpp: the 30-byte case of MementoBench.cpp, where the memento
+ * comes from the caretaker's arena and the undo rewinds it.
+ */
+#define main ArenaMementoDemo
+#include "Behavioral/Memento/ArenaMemento.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+BENCHMARK("Caretaker::Backup+Undo/30B") {
+    Originator originator("Super-duper-super-puper-super.");
+    Caretaker caretaker(&originator);
+    caretaker.Backup();
+    state.Measure([&] {
+        caretaker.Backup();
+        caretaker.Undo();
+    });
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Memento/ArenaMemento");
+}
@@ -0,0 +1,54 @@
+/**
+ * AsyncFacade.cpp: one operation through the sequential facade and through
+ * the one that runs independent steps concurrently. With no latency the
+ * concurrent facade pays for its threads; with 1 ms per subsystem call it
+ * saves the calls that overlap.
+ */
+#define main AsyncFacadeDemo
+#include "Structural/Facade/AsyncFacade.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+void Sequential(bench::State &state, std::chrono::milliseconds latency) {
+    Subsystem1 subsystem1(latency);
+    Subsystem2 subsystem2(latency);
+    Facade facade(&subsystem1, &subsystem2);
+    state.Measure([&] {
+        std::string result = facade.Operation();
+        bench::DoNotOptimize(result.data());
+    });
+}
+
+/**
+ * The facade deletes its subsystems.
+ */
+void Concurrent(bench::State &state, std::chrono::milliseconds latency) {
+    AsyncFacade facade(new Subsystem1(latency), new Subsystem2(latency));
+    std::string out;
+    state.Measure([&] {
+        out.clear();
+        facade.Operation(out);
+        bench::DoNotOptimize(out.data());
+    });
+}
+
+BENCHMARK("Facade::Operation/0ms") {
+    Sequential(state, std::chrono::milliseconds(0));
+}
+
+BENCHMARK("AsyncFacade::Operation/0ms") {
+    Concurrent(state, std::chrono::milliseconds(0));
+}
+
+BENCHMARK("Facade::Operation/1ms") {
+    Sequential(state, std::chrono::milliseconds(1));
+}
+
+BENCHMARK("AsyncFacade::Operation/1ms") {
+    Concurrent(state, std::chrono::milliseconds(1));
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Facade/AsyncFacade");
+}
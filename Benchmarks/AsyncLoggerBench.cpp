@@ -0,0 +1,51 @@
+/**
+ * AsyncLogger.cpp: adding a message from one thread under the Drop and Block
+ * policies; SingletonBench.cpp has the locked vector it replaces. The drain
+ * thread writes to file descriptor 1 directly, so each case points it at
+ * /dev/null and flushes the logger before putting it back.
+ */
+#define main AsyncLoggerDemo
+#include "Creational/Singleton/AsyncLogger.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+#include <fcntl.h>
+
+class DiscardStdout {
+public:
+    DiscardStdout() {
+        std::fflush(stdout);
+        saved_ = ::dup(STDOUT_FILENO);
+        int null = ::open("/dev/null", O_WRONLY);
+        ::dup2(null, STDOUT_FILENO);
+        ::close(null);
+    }
+    ~DiscardStdout() {
+        ::dup2(saved_, STDOUT_FILENO);
+        ::close(saved_);
+    }
+
+private:
+    int saved_;
+};
+
+void AddMessage(bench::State &state, Logger::Policy policy) {
+    DiscardStdout discard;
+    Logger &logger = Logger::GetInstance();
+    logger.setPolicy(policy);
+    state.Measure([&] { bench::DoNotOptimize(logger.addMessage("worker 1 message 1000")); });
+    logger.flush();
+}
+
+BENCHMARK("Logger::addMessage/Drop") {
+    AddMessage(state, Logger::Policy::Drop);
+}
+
+BENCHMARK("Logger::addMessage/Block") {
+    AddMessage(state, Logger::Policy::Block);
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Singleton/AsyncLogger");
+}
@@ -0,0 +1,49 @@
+/**
+ * AsyncObserver.cpp: publishing one message to 100 observers and waiting for
+ * every delivery, in both orderings. ObserverBench.cpp has the synchronous
+ * Notify. The observer only counts, so what is measured is the hand-off.
+ */
+#define main AsyncObserverDemo
+#include "Behavioral/Observer/AsyncObserver.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+class CountingObserver : public IObserver {
+public:
+    void Update(const std::string &message_from_subject) override {
+        this->updates_.fetch_add(message_from_subject.size(), std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<size_t> updates_{0};
+};
+
+void NotifyAndDrain(bench::State &state, AsyncSubject::Ordering ordering) {
+    ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+    AsyncSubject subject(pool, ordering);
+    std::vector<CountingObserver> observers(100);
+    for (CountingObserver &observer : observers) {
+        subject.Attach(&observer);
+    }
+    subject.CreateMessage("change message message");
+    state.Measure([&] {
+        subject.Notify();
+        subject.Drain();
+    });
+    for (CountingObserver &observer : observers) {
+        subject.Detach(&observer);
+    }
+}
+
+BENCHMARK("AsyncSubject::Notify+Drain/100/PerObserverFifo") {
+    NotifyAndDrain(state, AsyncSubject::Ordering::PerObserverFifo);
+}
+
+BENCHMARK("AsyncSubject::Notify+Drain/100/Unordered") {
+    NotifyAndDrain(state, AsyncSubject::Ordering::Unordered);
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Observer/AsyncObserver");
+}
@@ -0,0 +1,55 @@
+/**
+ * BatchVisitor.cpp: the 1000 random components of VisitorBench.cpp, visited
+ * one Accept at a time and as a partitioned batch, with and without the batch
+ * overrides.
+ */
+#define main BatchVisitorDemo
+#include "Behavioral/Visitor/BatchVisitor.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+struct Components {
+    Components() {
+        std::mt19937 random(42);
+        for (size_t i = 0; i < 1000; ++i) {
+            int value = static_cast<int>(random() % 1000);
+            if (random() % 2) {
+                owned_.push_back(std::make_unique<ConcreteComponentA>(value));
+            } else {
+                owned_.push_back(std::make_unique<ConcreteComponentB>(value));
+            }
+            mixed_.push_back(owned_.back().get());
+        }
+    }
+    std::vector<std::unique_ptr<Component>> owned_;
+    std::vector<const Component *> mixed_;
+};
+
+BENCHMARK("Component::Accept/1000") {
+    Components components;
+    ChecksumVisitor visitor;
+    state.Measure([&] { ClientCode(components.mixed_, &visitor); });
+    bench::DoNotOptimize(visitor.sum_a_ + visitor.sum_b_);
+}
+
+template <typename V>
+void AcceptBatch(bench::State &state) {
+    Components components;
+    VisitorBatch batch(components.mixed_);
+    V visitor;
+    state.Measure([&] { batch.Accept(visitor); });
+    bench::DoNotOptimize(visitor.sum_a_ + visitor.sum_b_);
+}
+
+BENCHMARK("VisitorBatch::Accept/1000/ChecksumVisitor") {
+    AcceptBatch<ChecksumVisitor>(state);
+}
+
+BENCHMARK("VisitorBatch::Accept/1000/BatchChecksumVisitor") {
+    AcceptBatch<BatchChecksumVisitor>(state);
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Visitor/BatchVisitor");
+}
@@ -0,0 +1,448 @@
+/**
+ * The benchmark harness shared by the pattern benchmarks.
+ *
+ * Each benchmark in this directory includes one pattern file, with its main()
+ * renamed, and registers cases for the pattern's hot operations:
+ *
+ *     BENCHMARK("Subject::Notify/100") {
+ *         Subject subject;            // set up once, not timed
+ *         ...
+ *         state.Measure([&] { subject.Notify(); });
+ *     }
+ *
+ * Measure() picks an iteration count that runs for at least --min-time and
+ * reports the median of --repetitions runs: nanoseconds, heap allocations and,
+ * where the kernel allows it, hardware counters per operation. Anything the
+ * pattern prints to std::cout is thrown away while the cases run, but the
+ * formatting still happens and is part of the time.
+ *
+ * Allocations are counted by the global operator new of
+ * Common/HeapAllocations.h, which pattern files that count their own
+ * allocations include as well.
+ */
+#ifndef BENCHMARKS_BENCHMARK_H
+#define BENCHMARKS_BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "../Common/HeapAllocations.h"
+
+/**
+ * Filled in by Benchmarks/CMakeLists.txt, so every result records the build
+ * it came from.
+ */
+#ifndef BENCH_BUILD_TYPE
+#define BENCH_BUILD_TYPE ""
+#endif
+#ifndef BENCH_FLAGS
+#define BENCH_FLAGS ""
+#endif
+#ifndef BENCH_LTO
+#define BENCH_LTO 0
+#endif
+#ifndef BENCH_COMPILER
+#define BENCH_COMPILER __VERSION__
+#endif
+
+namespace bench {
+
+/**
+ * Keeps the compiler from discarding a value the benchmark computes but never
+ * uses.
+ */
+template <typename T>
+inline void DoNotOptimize(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * Cycles, instructions, cache misses and branch misses of this thread in user
+ * space, counted together as one perf event group. Where perf_event_open is
+ * missing or not permitted (other systems, containers, a high
+ * perf_event_paranoid) the group stays closed and no counters are reported.
+ */
+class HardwareCounters {
+public:
+    static constexpr size_t kCount = 4;
+
+    HardwareCounters() {
+#ifdef __linux__
+        static constexpr uint64_t kEvents[kCount] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                     PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+        for (size_t i = 0; i < kCount; ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = kEvents[i];
+            attr.disabled = i == 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+            int fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, i == 0 ? -1 : this->fds_[0], 0));
+            if (fd < 0) {
+                this->Close();
+                return;
+            }
+            this->fds_[i] = fd;
+        }
+#endif
+    }
+    ~HardwareCounters() {
+        this->Close();
+    }
+
+    HardwareCounters(const HardwareCounters &) = delete;
+    HardwareCounters &operator=(const HardwareCounters &) = delete;
+
+    bool available() const {
+        return this->fds_[0] >= 0;
+    }
+
+    void Start() {
+#ifdef __linux__
+        if (this->available()) {
+            ioctl(this->fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(this->fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+
+    /**
+     * Stops counting and reads the counts since Start(). Returns false if
+     * there are no counters.
+     */
+    bool Stop(uint64_t (&values)[kCount]) {
+#ifdef __linux__
+        if (this->available()) {
+            ioctl(this->fds_[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+            struct {
+                uint64_t nr_;
+                uint64_t values_[kCount];
+            } group;
+            if (read(this->fds_[0], &group, sizeof(group)) == static_cast<ssize_t>(sizeof(group)) && group.nr_ == kCount) {
+                std::copy(group.values_, group.values_ + kCount, values);
+                return true;
+            }
+        }
+#endif
+        (void)values;
+        return false;
+    }
+
+private:
+    int fds_[kCount] = {-1, -1, -1, -1};
+
+    void Close() {
+        for (int &fd : this->fds_) {
+#ifdef __linux__
+            if (fd >= 0) {
+                close(fd);
+            }
+#endif
+            fd = -1;
+        }
+    }
+};
+
+/**
+ * One run of a case: `iterations_` calls of the operation and what they cost.
+ */
+struct Sample {
+    size_t iterations_ = 0;
+    double ns_per_op_ = 0;
+    double allocs_per_op_ = 0;
+    bool counted_ = false;
+    double counters_per_op_[HardwareCounters::kCount] = {};
+};
+
+struct Options {
+    double min_time_ = 0.2;
+    size_t repetitions_ = 5;
+};
+
+/**
+ * What a case gets: it sets up its objects, then hands the operation to
+ * Measure(). A case calls Measure() once.
+ */
+class State {
+public:
+    State(const Options &options, HardwareCounters &counters) : options_(options), counters_(counters) {}
+
+    template <typename Op>
+    void Measure(Op &&op) {
+        // Grow the count until one run takes a tenth of the minimum time, then
+        // scale it up to the minimum; this also warms the caches and the pools.
+        const double min_ns = this->options_.min_time_ * 1e9;
+        size_t iterations = 1;
+        double ns = Time(iterations, op);
+        while (ns < min_ns / 10 && iterations < kMaxIterations) {
+            iterations *= 10;
+            ns = Time(iterations, op);
+        }
+        if (ns < min_ns) {
+            iterations = static_cast<size_t>(std::min(static_cast<double>(kMaxIterations), iterations * min_ns / std::max(ns, 1.0))) + 1;
+        }
+
+        std::vector<Sample> samples;
+        for (size_t i = 0; i < std::max<size_t>(this->options_.repetitions_, 1); ++i) {
+            samples.push_back(this->Run(iterations, op));
+        }
+        std::sort(samples.begin(), samples.end(), [](const Sample &a, const Sample &b) { return a.ns_per_op_ < b.ns_per_op_; });
+        this->result_ = samples[samples.size() / 2];
+        this->measured_ = true;
+    }
+
+    bool measured() const {
+        return this->measured_;
+    }
+    const Sample &result() const {
+        return this->result_;
+    }
+
+private:
+    static constexpr size_t kMaxIterations = 1000000000;
+
+    const Options &options_;
+    HardwareCounters &counters_;
+    Sample result_;
+    bool measured_ = false;
+
+    template <typename Op>
+    static double Time(size_t iterations, Op &op) {
+        auto begin = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            op();
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+    }
+
+    template <typename Op>
+    Sample Run(size_t iterations, Op &op) {
+        Sample sample;
+        sample.iterations_ = iterations;
+        uint64_t counts[HardwareCounters::kCount];
+        size_t allocations = g_HeapAllocations;
+        this->counters_.Start();
+        double ns = Time(iterations, op);
+        sample.counted_ = this->counters_.Stop(counts);
+        allocations = g_HeapAllocations - allocations;
+        sample.ns_per_op_ = ns / iterations;
+        sample.allocs_per_op_ = static_cast<double>(allocations) / iterations;
+        for (size_t i = 0; sample.counted_ && i < HardwareCounters::kCount; ++i) {
+            sample.counters_per_op_[i] = static_cast<double>(counts[i]) / iterations;
+        }
+        return sample;
+    }
+};
+
+struct Case {
+    const char *name_;
+    void (*run_)(State &);
+};
+
+inline std::vector<Case> &Cases() {
+    static std::vector<Case> cases;
+    return cases;
+}
+
+struct Registration {
+    Registration(const char *name, void (*run)(State &)) {
+        Cases().push_back({name, run});
+    }
+};
+
+/**
+ * Swallows everything written to it.
+ */
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override {
+        return traits_type::not_eof(c);
+    }
+    std::streamsize xsputn(const char *, std::streamsize n) override {
+        return n;
+    }
+};
+
+/**
+ * Writes `s` as a JSON string. Case names are plain text, so only quotes,
+ * backslashes and control characters need escaping.
+ */
+inline void WriteJsonString(std::FILE *out, const char *s) {
+    std::fputc('"', out);
+    for (; *s != '\0'; ++s) {
+        unsigned char c = static_cast<unsigned char>(*s);
+        if (c == '"' || c == '\\') {
+            std::fprintf(out, "\\%c", c);
+        } else if (c < 0x20) {
+            std::fprintf(out, "\\u%04x", c);
+        } else {
+            std::fputc(c, out);
+        }
+    }
+    std::fputc('"', out);
+}
+
+/**
+ * One JSON object per line, so results from many benchmarks, builds and
+ * revisions can be appended to the same file and compared later.
+ */
+inline void WriteJson(std::FILE *out, const char *suite, const char *name, const Sample &sample, const std::string &revision, long long timestamp) {
+    static const char *const kCounterNames[HardwareCounters::kCount] = {"cycles_per_op", "instructions_per_op", "cache_misses_per_op",
+                                                                        "branch_misses_per_op"};
+    std::fputs("{\"suite\":", out);
+    WriteJsonString(out, suite);
+    std::fputs(",\"case\":", out);
+    WriteJsonString(out, name);
+    std::fprintf(out, ",\"iterations\":%zu,\"ns_per_op\":%.3f,\"allocs_per_op\":%.3f", sample.iterations_, sample.ns_per_op_, sample.allocs_per_op_);
+    for (size_t i = 0; i < HardwareCounters::kCount; ++i) {
+        if (sample.counted_) {
+            std::fprintf(out, ",\"%s\":%.3f", kCounterNames[i], sample.counters_per_op_[i]);
+        } else {
+            std::fprintf(out, ",\"%s\":null", kCounterNames[i]);
+        }
+    }
+    std::fputs(",\"build_type\":", out);
+    WriteJsonString(out, BENCH_BUILD_TYPE);
+    std::fputs(",\"flags\":", out);
+    WriteJsonString(out, BENCH_FLAGS);
+    std::fprintf(out, ",\"lto\":%s,\"compiler\":", BENCH_LTO ? "true" : "false");
+    WriteJsonString(out, BENCH_COMPILER);
+    std::fputs(",\"revision\":", out);
+    WriteJsonString(out, revision.c_str());
+    std::fprintf(out, ",\"timestamp\":%lld}\n", timestamp);
+}
+
+inline void PrintCounter(const Sample &sample, size_t i) {
+    if (sample.counted_) {
+        std::printf(" %14.1f", sample.counters_per_op_[i]);
+    } else {
+        std::printf(" %14s", "-");
+    }
+}
+
+inline int Usage(const char *program) {
+    std::fprintf(stderr,
+                 "usage: %s [--filter TEXT] [--min-time SECONDS] [--repetitions N] [--json FILE] [--revision TEXT] [--list]\n"
+                 "  --filter TEXT      run only the cases whose name contains TEXT\n"
+                 "  --min-time SEC     minimum time of one run of a case (default 0.2)\n"
+                 "  --repetitions N    runs per case; the median is reported (default 5)\n"
+                 "  --json FILE        append one JSON line per case to FILE\n"
+                 "  --revision TEXT    source revision to record in the JSON lines\n"
+                 "  --list             print the names of the cases that would run and exit\n",
+                 program);
+    return 2;
+}
+
+/**
+ * Runs the registered cases of `suite` (the pattern and the file it comes
+ * from, such as "Observer/SnapshotObserver"), prints a table and optionally
+ * appends the results to a JSON-lines file.
+ */
+inline int Main(int argc, char **argv, const char *suite) {
+    Options options;
+    std::string filter, json, revision;
+    bool list = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--filter" && has_value) {
+            filter = argv[++i];
+        } else if (arg == "--min-time" && has_value) {
+            options.min_time_ = std::atof(argv[++i]);
+        } else if (arg == "--repetitions" && has_value) {
+            options.repetitions_ = static_cast<size_t>(std::atol(argv[++i]));
+        } else if (arg == "--json" && has_value) {
+            json = argv[++i];
+        } else if (arg == "--revision" && has_value) {
+            revision = argv[++i];
+        } else if (arg == "--list") {
+            list = true;
+        } else {
+            return Usage(argv[0]);
+        }
+    }
+    if (list) {
+        for (const Case &c : Cases()) {
+            if (filter.empty() || std::strstr(c.name_, filter.c_str()) != nullptr) {
+                std::printf("%s\n", c.name_);
+            }
+        }
+        return 0;
+    }
+
+    std::FILE *out = nullptr;
+    if (!json.empty() && (out = std::fopen(json.c_str(), "a")) == nullptr) {
+        std::fprintf(stderr, "%s: cannot open %s\n", argv[0], json.c_str());
+        return 1;
+    }
+
+    HardwareCounters counters;
+    std::printf("%s (%s; %s %s%s)\n", suite, BENCH_COMPILER, BENCH_BUILD_TYPE, BENCH_FLAGS, BENCH_LTO ? " LTO" : "");
+    std::printf("%-44s %12s %12s %12s %14s %14s %14s %14s\n", "case", "iterations", "ns/op", "allocs/op", "cycles/op", "instr/op",
+                "cache-miss/op", "branch-miss/op");
+    long long timestamp = static_cast<long long>(std::time(nullptr));
+    NullBuffer null;
+    for (const Case &c : Cases()) {
+        if (!filter.empty() && std::strstr(c.name_, filter.c_str()) == nullptr) {
+            continue;
+        }
+        State state(options, counters);
+        std::streambuf *console = std::cout.rdbuf(&null);
+        c.run_(state);
+        std::cout.rdbuf(console);
+        if (!state.measured()) {
+            std::printf("%-44s did not call Measure()\n", c.name_);
+            continue;
+        }
+        const Sample &sample = state.result();
+        std::printf("%-44s %12zu %12.1f %12.2f", c.name_, sample.iterations_, sample.ns_per_op_, sample.allocs_per_op_);
+        for (size_t i = 0; i < HardwareCounters::kCount; ++i) {
+            PrintCounter(sample, i);
+        }
+        std::printf("\n");
+        if (out != nullptr) {
+            WriteJson(out, suite, c.name_, sample, revision, timestamp);
+        }
+    }
+    if (!counters.available()) {
+        std::printf("(hardware counters are not available here)\n");
+    }
+    if (out != nullptr) {
+        std::fclose(out);
+    }
+    return 0;
+}
+
+}
+
+#define BENCH_JOIN_(a, b) a##b
+#define BENCH_JOIN(a, b) BENCH_JOIN_(a, b)
+
+/**
+ * Defines and registers a case; the body sees `bench::State &state`.
+ */
+#define BENCHMARK(name)                                                                                     \
+    static void BENCH_JOIN(BenchCase, __LINE__)(bench::State &);                                            \
+    static bench::Registration BENCH_JOIN(g_BenchRegistration, __LINE__)(name, BENCH_JOIN(BenchCase, __LINE__)); \
+    static void BENCH_JOIN(BenchCase, __LINE__)(bench::State &state)
+
+#endif
@@ -0,0 +1,26 @@
+/**
+ * Builder.cpp: building one full featured product through the Director, the
+ * baseline of ReusableBuilderBench.cpp and StaticDirectorBench.cpp. Every
+ * product is a new heap object with std::string parts.
+ */
+#define main BuilderDemo
+#include "Creational/Builder/Builder.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+BENCHMARK("Director::BuildFullFeaturedProduct+GetProduct") {
+    ConcreteBuilder1 builder;
+    Director director;
+    director.set_builder(&builder);
+    state.Measure([&] {
+        director.BuildFullFeaturedProduct();
+        Product1 *product = builder.GetProduct();
+        bench::DoNotOptimize(product->parts_.size());
+        delete product;
+    });
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Builder/Builder");
+}
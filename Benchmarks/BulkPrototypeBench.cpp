@@ -0,0 +1,30 @@
+/**
+ * BulkPrototype.cpp: the case of PrototypeBench.cpp, and spawning 1000 copies
+ * at once into one block.
+ */
+#define main BulkPrototypeDemo
+#include "Creational/Prototype/BulkPrototype.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+BENCHMARK("PrototypeFactory::CreatePrototype") {
+    PrototypeFactory factory;
+    state.Measure([&] {
+        Prototype *prototype = factory.CreatePrototype(Type::PROTOTYPE_1);
+        bench::DoNotOptimize(prototype);
+        delete prototype;
+    });
+}
+
+BENCHMARK("PrototypeFactory::CloneN/1000") {
+    PrototypeFactory factory;
+    state.Measure([&] {
+        PrototypeBlock block = factory.CloneN(Type::PROTOTYPE_1, 1000);
+        bench::DoNotOptimize(&block[999]);
+    });
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Prototype/BulkPrototype");
+}
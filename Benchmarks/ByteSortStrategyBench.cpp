@@ -0,0 +1,68 @@
+/**
+ * ByteSortStrategy.cpp: the random-byte cases of StrategyBench.cpp through
+ * each strategy and through the context that picks one from the size. At
+ * 4 MiB the adaptive context picks the parallel sort.
+ */
+#define main ByteSortStrategyDemo
+#include "Behavioral/Strategy/ByteSortStrategy.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+std::string RandomBytes(size_t size) {
+    std::mt19937_64 random(1);
+    std::string bytes(size, '\0');
+    for (char &c : bytes) {
+        c = static_cast<char>(random());
+    }
+    return bytes;
+}
+
+void DoAlgorithm(bench::State &state, const Strategy &strategy, size_t size) {
+    std::string data = RandomBytes(size);
+    state.Measure([&] {
+        std::string result = strategy.doAlgorithm(data);
+        bench::DoNotOptimize(result.data());
+    });
+}
+
+void Sort(bench::State &state, size_t size) {
+    AdaptiveContext context;
+    std::string data = RandomBytes(size);
+    state.Measure([&] {
+        std::string result = context.Sort(data);
+        bench::DoNotOptimize(result.data());
+    });
+}
+
+BENCHMARK("AdaptiveContext::Sort/5") {
+    Sort(state, 5);
+}
+
+BENCHMARK("ConcreteStrategyA::doAlgorithm/64KiB") {
+    DoAlgorithm(state, ConcreteStrategyA(), 64 << 10);
+}
+
+BENCHMARK("CountingSortStrategy::doAlgorithm/64KiB") {
+    DoAlgorithm(state, CountingSortStrategy(), 64 << 10);
+}
+
+BENCHMARK("AdaptiveContext::Sort/64KiB") {
+    Sort(state, 64 << 10);
+}
+
+BENCHMARK("CountingSortStrategy::doAlgorithm/4MiB") {
+    DoAlgorithm(state, CountingSortStrategy(), 4 << 20);
+}
+
+BENCHMARK("ParallelSortStrategy::doAlgorithm/4MiB") {
+    DoAlgorithm(state, ParallelSortStrategy(), 4 << 20);
+}
+
+BENCHMARK("AdaptiveContext::Sort/4MiB") {
+    Sort(state, 4 << 20);
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Strategy/ByteSortStrategy");
+}
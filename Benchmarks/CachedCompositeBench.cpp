@@ -0,0 +1,48 @@
+/**
+ * CachedComposite.cpp: the case of CompositeBench.cpp, where the text is
+ * built on demand, and the cached aggregates after one leaf changed.
+ */
+#define main CachedCompositeDemo
+#include "Structural/Composite/CachedComposite.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+#include <memory>
+#include <vector>
+
+BENCHMARK("Component::Operation/1024") {
+    std::vector<std::unique_ptr<Component<LabelHash>>> owned;
+    std::vector<Leaf<LabelHash> *> leaves;
+    Component<LabelHash> *tree = Build(4, 5, owned, leaves);
+    state.Measure([&] { bench::DoNotOptimize(tree->Operation()); });
+}
+
+/**
+ * Re-evaluates the changed leaf and its five ancestors, each combining four
+ * cached values.
+ */
+template <typename Aggregate>
+void SetLabelAndResult(bench::State &state) {
+    std::vector<std::unique_ptr<Component<Aggregate>>> owned;
+    std::vector<Leaf<Aggregate> *> leaves;
+    Component<Aggregate> *tree = Build(4, 5, owned, leaves);
+    Leaf<Aggregate> *leaf = leaves[leaves.size() / 2];
+    bool moss = false;
+    state.Measure([&] {
+        leaf->SetLabel((moss = !moss) ? "Moss" : "Leaf");
+        bench::DoNotOptimize(tree->Result());
+    });
+}
+
+BENCHMARK("Leaf::SetLabel+Result/1024/LabelHash") {
+    SetLabelAndResult<LabelHash>(state);
+}
+
+BENCHMARK("Leaf::SetLabel+Result/1024/LabelLength") {
+    SetLabelAndResult<LabelLength>(state);
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Composite/CachedComposite");
+}
@@ -0,0 +1,61 @@
+/**
+ * CachingProxy.cpp: what each proxy itself costs, in front of the subject
+ * that answers at once. The caching proxy is measured on a hit and on a miss,
+ * where 64 arguments take turns in a cache of 16. The protection proxy runs
+ * without an access log, since a log kept in memory would grow with every
+ * request.
+ */
+#define main CachingProxyDemo
+#include "Structural/Proxy/CachingProxy.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+void Request(bench::State &state, const Subject &subject) {
+    state.Measure([&] {
+        std::string result = subject.Request("item");
+        bench::DoNotOptimize(result.data());
+    });
+}
+
+BENCHMARK("EchoSubject::Request") {
+    EchoSubject echo;
+    Request(state, echo);
+}
+
+BENCHMARK("LazyProxy::Request") {
+    LazyProxy lazy([] { return std::make_unique<EchoSubject>(); });
+    Request(state, lazy);
+}
+
+BENCHMARK("CachingProxy::Request/hit") {
+    EchoSubject echo;
+    CachingProxy caching(echo);
+    Request(state, caching);
+}
+
+BENCHMARK("CachingProxy::Request/miss") {
+    EchoSubject echo;
+    CacheOptions options;
+    options.capacity_ = 16;
+    CachingProxy caching(echo, options);
+    std::vector<std::string> arguments;
+    for (size_t i = 0; i < 64; ++i) {
+        arguments.push_back("item" + std::to_string(i));
+    }
+    size_t i = 0;
+    state.Measure([&] {
+        std::string result = caching.Request(arguments[i++ % arguments.size()]);
+        bench::DoNotOptimize(result.data());
+    });
+}
+
+BENCHMARK("ProtectionProxy::Request") {
+    EchoSubject echo;
+    ProtectionProxy proxy(echo, [](std::thread::id) { return true; });
+    Request(state, proxy);
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Proxy/CachingProxy");
+}
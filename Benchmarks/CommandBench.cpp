@@ -0,0 +1,31 @@
+/**
+ * Command.cpp: the invoker running its two commands, and one command made,
+ * executed and deleted on the caller, the baselines of CommandQueueBench.cpp.
+ * The commands print to std::cout, which the benchmarks discard.
+ */
+#define main CommandDemo
+#include "Behavioral/Command/Command.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+BENCHMARK("Invoker::DoSomethingImportant") {
+    Reciever reciever;
+    Invoker invoker;
+    invoker.SetOnStart(new SimpleCommand("Say Hi!"));
+    invoker.SetOnFinish(new ComplexCommand(&reciever, "Send email", "Save report"));
+    state.Measure([&] { invoker.DoSomethingImportant(); });
+}
+
+BENCHMARK("ComplexCommand new+Execute+delete") {
+    Reciever reciever;
+    state.Measure([&] {
+        Command *command = new ComplexCommand(&reciever, "Send email", "Save report");
+        command->Execute();
+        delete command;
+    });
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Command/Command");
+}
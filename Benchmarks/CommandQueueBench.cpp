@@ -0,0 +1,47 @@
+/**
+ * CommandQueue.cpp: the cases of CommandBench.cpp with commands held by
+ * value, and the quiet command of the demo run on the caller and submitted to
+ * the executor. Submit is timed alone: the workers drain the queue meanwhile,
+ * so a full queue shows up as a slower Submit.
+ */
+#define main CommandQueueDemo
+#include "Behavioral/Command/CommandQueue.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+BENCHMARK("Invoker::DoSomethingImportant") {
+    Reciever reciever;
+    Invoker invoker;
+    invoker.SetOnStart(SimpleCommand("Say Hi!"));
+    invoker.SetOnFinish(ComplexCommand(&reciever, "Send email", "Save report"));
+    state.Measure([&] { invoker.DoSomethingImportant(); });
+}
+
+BENCHMARK("InlineCommand(ComplexCommand)+Execute") {
+    Reciever reciever;
+    state.Measure([&] {
+        InlineCommand command(ComplexCommand(&reciever, "Send email", "Save report"));
+        command.Execute();
+    });
+}
+
+BENCHMARK("TallyCommand new+Execute+delete") {
+    TallyReciever tally;
+    state.Measure([&] {
+        Command *command = new TallyCommand(&tally, "Send email", "Save report");
+        command->Execute();
+        delete command;
+    });
+}
+
+BENCHMARK("CommandExecutor::Submit(TallyCommand)") {
+    TallyReciever tally;
+    CommandExecutor executor(std::max(1u, std::thread::hardware_concurrency()), 4096, 32);
+    state.Measure([&] { executor.Submit(TallyCommand(&tally, "Send email", "Save report")); });
+    executor.WaitIdle();
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Command/CommandQueue");
+}
@@ -0,0 +1,42 @@
+/**
+ * CompiledChain.cpp: the case of ResponsibilityChainBench.cpp through the
+ * linked handlers and through the compiled table, which answers into a
+ * reused buffer.
+ */
+#define main CompiledChainDemo
+#include "Behavioral/ResponsibilityChain/CompiledChain.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+const std::string kFood[] = {"Nut", "Banana", "Cup of coffee", "MeatBall"};
+
+BENCHMARK("Handler::Handle/3") {
+    MonkeyHandler monkey;
+    SquirrelHandler squirrel;
+    DogHandler dog;
+    monkey.SetNext(&squirrel)->SetNext(&dog);
+    size_t i = 0;
+    state.Measure([&] {
+        std::string result = monkey.Handle(kFood[i++ % 4]);
+        bench::DoNotOptimize(result.size());
+    });
+}
+
+BENCHMARK("CompiledChain::Handle/3") {
+    MonkeyHandler monkey;
+    SquirrelHandler squirrel;
+    DogHandler dog;
+    monkey.SetNext(&squirrel)->SetNext(&dog);
+    CompiledChain chain = CompiledChain::Compile(monkey);
+    std::string result;
+    size_t i = 0;
+    state.Measure([&] {
+        result.clear();
+        bench::DoNotOptimize(chain.Handle(kFood[i++ % 4], result));
+    });
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "ResponsibilityChain/CompiledChain");
+}
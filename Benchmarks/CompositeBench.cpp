@@ -0,0 +1,31 @@
+/**
+ * Composite.cpp: the operation of a balanced tree with 4 children per branch
+ * and 1024 leaves.
+ */
+#define main CompositeDemo
+#include "Structural/Composite/Composite.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+#include <memory>
+#include <vector>
+
+Component *Build(int fanout, int depth, std::vector<std::unique_ptr<Component>> &owned) {
+    owned.push_back(depth == 0 ? std::unique_ptr<Component>(new Leaf) : std::unique_ptr<Component>(new Composite));
+    Component *component = owned.back().get();
+    for (int i = 0; depth > 0 && i < fanout; ++i) {
+        component->Add(Build(fanout, depth - 1, owned));
+    }
+    return component;
+}
+
+BENCHMARK("Component::Operation/1024") {
+    std::vector<std::unique_ptr<Component>> owned;
+    Component *tree = Build(4, 5, owned);
+    state.Measure([&] { bench::DoNotOptimize(tree->Operation()); });
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Composite/Composite");
+}
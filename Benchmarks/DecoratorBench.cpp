@@ -0,0 +1,44 @@
+/**
+ * Decorator.cpp: the demo's chain of two decorators and a chain sixteen deep,
+ * alternating A and B. Every decorator returns a new string. The baseline of
+ * SinkDecoratorBench.cpp.
+ */
+#define main DecoratorDemo
+#include "Structural/Decorator/Decorator.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+#include <memory>
+#include <vector>
+
+template <size_t Depth>
+void Operation(bench::State &state) {
+    ConcreteComponent simple;
+    std::vector<std::unique_ptr<Component>> chain;
+    for (size_t i = 0; i < Depth; ++i) {
+        Component *inner = i == 0 ? static_cast<Component *>(&simple) : chain.back().get();
+        if (i % 2 == 0) {
+            chain.push_back(std::make_unique<ConcreteDecoratorA>(inner));
+        } else {
+            chain.push_back(std::make_unique<ConcreteDecoratorB>(inner));
+        }
+    }
+    const Component &top = *chain.back();
+    state.Measure([&] {
+        std::string result = top.Operation();
+        bench::DoNotOptimize(result.data());
+    });
+}
+
+BENCHMARK("Component::Operation/2") {
+    Operation<2>(state);
+}
+
+BENCHMARK("Component::Operation/16") {
+    Operation<16>(state);
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Decorator/Decorator");
+}
@@ -0,0 +1,48 @@
+/**
+ * DeltaMemento.cpp: the 64 KiB case of MementoBench.cpp, after a history of
+ * edits like the demo's, where an undo rebuilds the state from the last
+ * keyframe. Editing and saving on its own is measured too; the budget keeps
+ * that history bounded.
+ */
+#define main DeltaMementoDemo
+#include "Behavioral/Memento/DeltaMemento.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+std::string Document() {
+    std::string document;
+    while (document.size() < 64 * 1024) {
+        document += "Super-duper-super-puper-super. ";
+    }
+    document.resize(64 * 1024);
+    return document;
+}
+
+BENCHMARK("Caretaker::Backup+Undo/64KiB") {
+    std::srand(1);
+    Originator originator(Document());
+    Caretaker caretaker(&originator, 16, 1024 * 1024);
+    for (int i = 0; i < 1000; ++i) {
+        caretaker.Backup();
+        originator.DoSomething();
+    }
+    state.Measure([&] {
+        caretaker.Backup();
+        caretaker.Undo();
+    });
+}
+
+BENCHMARK("Originator::DoSomething+Caretaker::Backup/64KiB") {
+    std::srand(1);
+    Originator originator(Document());
+    Caretaker caretaker(&originator, 16, 1024 * 1024);
+    state.Measure([&] {
+        originator.DoSomething();
+        caretaker.Backup();
+    });
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Memento/DeltaMemento");
+}
@@ -0,0 +1,67 @@
+/**
+ * EntityStorage.cpp: one frame over 10000 objects, as the vector of pointers
+ * of ExtensibleFactoryBench.cpp and as typed arrays, on one thread and on the
+ * frame workers.
+ */
+#define main EntityStorageDemo
+#include "Creational/ExtensibleFactory/EntityStorage.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+struct Entities {
+    explicit Entities(size_t count) {
+        const char *types[] = {"plane", "boat", "ant"};
+        std::mt19937 random(7);
+        storage_.Reserve(count / 3 + 1, count / 3 + 1, count / 3 + 1);
+        for (size_t i = 0; i < count; ++i) {
+            std::string_view type = types[random() % 3];
+            float x = static_cast<float>(random() % 100), y = static_cast<float>(random() % 100);
+            if (type == "plane") {
+                owned_.push_back(std::make_unique<Plane>(x, y));
+            } else if (type == "boat") {
+                owned_.push_back(std::make_unique<Boat>(x, y));
+            } else {
+                owned_.push_back(std::make_unique<Ant>(x, y));
+            }
+            storage_.Spawn(type, x, y);
+        }
+    }
+    std::vector<std::unique_ptr<IGameObject>> owned_;
+    EntityStorage storage_;
+};
+
+BENCHMARK("Update+Render/10000/pointers") {
+    Entities entities(10000);
+    std::ostringstream out;
+    state.Measure([&] {
+        out.str("");
+        for (auto &e : entities.owned_) {
+            e->Update(1.0f / 60);
+            e->Render(out);
+        }
+    });
+}
+
+void UpdateAndRender(bench::State &state, FrameWorkers *workers) {
+    Entities entities(10000);
+    std::string frame;
+    state.Measure([&] {
+        entities.storage_.Update(1.0f / 60, workers);
+        entities.storage_.Render(frame);
+    });
+    bench::DoNotOptimize(entities.storage_.Checksum());
+}
+
+BENCHMARK("EntityStorage::Update+Render/10000") {
+    UpdateAndRender(state, nullptr);
+}
+
+BENCHMARK("EntityStorage::Update+Render/10000/FrameWorkers") {
+    FrameWorkers workers(std::max(1u, std::thread::hardware_concurrency()));
+    UpdateAndRender(state, &workers);
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "ExtensibleFactory/EntityStorage");
+}
@@ -0,0 +1,47 @@
+/**
+ * ExtensibleFactory.cpp: creating one object by name and a frame over 10000
+ * objects, the baselines of PooledFactoryBench.cpp and EntityStorageBench.cpp.
+ * The objects render to std::cout, which the benchmarks discard.
+ */
+#define main ExtensibleFactoryDemo
+#include "Creational/ExtensibleFactory/ExtensibleFactory.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+#include <random>
+
+void RegisterTypes() {
+    GameObjectFactory::RegisterObject("plane", Plane::Create);
+    GameObjectFactory::RegisterObject("boat", Boat::Create);
+    GameObjectFactory::RegisterObject("ant", Ant::Create);
+}
+
+BENCHMARK("GameObjectFactory::CreateSingleObject") {
+    RegisterTypes();
+    state.Measure([&] {
+        IGameObject *object = GameObjectFactory::CreateSingleObject("boat");
+        bench::DoNotOptimize(object);
+        delete object;
+    });
+}
+
+BENCHMARK("Update+Render/10000") {
+    RegisterTypes();
+    const char *types[] = {"plane", "boat", "ant"};
+    std::mt19937 random(7);
+    std::vector<std::unique_ptr<IGameObject>> owned;
+    for (size_t i = 0; i < 10000; ++i) {
+        owned.emplace_back(GameObjectFactory::CreateSingleObject(types[random() % 3]));
+    }
+    state.Measure([&] {
+        for (auto &e : owned) {
+            e->Update();
+            e->Render();
+        }
+    });
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "ExtensibleFactory/ExtensibleFactory");
+}
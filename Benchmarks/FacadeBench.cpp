@@ -0,0 +1,21 @@
+/**
+ * Facade.cpp: one operation through the facade, the baseline of
+ * AsyncFacadeBench.cpp.
+ */
+#define main FacadeDemo
+#include "Structural/Facade/Facade.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+BENCHMARK("Facade::Operation") {
+    Facade facade;
+    state.Measure([&] {
+        std::string result = facade.Operation();
+        bench::DoNotOptimize(result.data());
+    });
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Facade/Facade");
+}
@@ -0,0 +1,33 @@
+/**
+ * FlatComposite.cpp: the case of CompositeBench.cpp through a view of the
+ * flat tree, and writing the same result into a buffer that is reused.
+ */
+#define main FlatCompositeDemo
+#include "Structural/Composite/FlatComposite.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+#include <string>
+
+BENCHMARK("Component::Operation/1024") {
+    FlatTree tree;
+    BuildFlat(tree, 4, 5);
+    FlatComponent root = tree.View(0);
+    state.Measure([&] { bench::DoNotOptimize(root.Operation()); });
+}
+
+BENCHMARK("FlatTree::Write/1024") {
+    FlatTree tree;
+    BuildFlat(tree, 4, 5);
+    std::string out;
+    state.Measure([&] {
+        out.clear();
+        tree.Write(0, out);
+        bench::DoNotOptimize(out.data());
+    });
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Composite/FlatComposite");
+}
@@ -0,0 +1,25 @@
+/**
+ * Flyweight.cpp: looking up the flyweight of a car already in the factory.
+ */
+#define main FlyweightDemo
+#include "Structural/Flyweight/Flyweight.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+#include <vector>
+
+BENCHMARK("FlyweightFactory::GetFlyweight/hit") {
+    std::vector<SharedState> cars = {{"Chevrolet", "Camaro2018", "pink"}, {"Mercedes Benz", "C300", "black"}, {"Mercedes Benz", "C500", "red"},
+                                     {"BMW", "M5", "red"}, {"BMW", "X6", "white"}};
+    FlyweightFactory factory({cars[0], cars[1], cars[2], cars[3], cars[4]});
+    size_t i = 0;
+    state.Measure([&] {
+        Flyweight flyweight = factory.GetFlyweight(cars[i++ % cars.size()]);
+        bench::DoNotOptimize(flyweight.shared_state());
+    });
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Flyweight/Flyweight");
+}
@@ -0,0 +1,26 @@
+/**
+ * InternedFlyweight.cpp: the lookup of FlyweightBench.cpp.
+ */
+#define main InternedFlyweightDemo
+#include "Structural/Flyweight/InternedFlyweight.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+#include <vector>
+
+BENCHMARK("FlyweightFactory::GetFlyweight/hit") {
+    std::vector<FlyweightFactory::Key> cars = {{"Chevrolet", "Camaro2018", "pink"}, {"Mercedes Benz", "C300", "black"}, {"Mercedes Benz", "C500", "red"},
+                                               {"BMW", "M5", "red"}, {"BMW", "X6", "white"}};
+    FlyweightFactory factory({cars[0], cars[1], cars[2], cars[3], cars[4]});
+    size_t i = 0;
+    state.Measure([&] {
+        const FlyweightFactory::Key &car = cars[i++ % cars.size()];
+        Flyweight flyweight = factory.GetFlyweight(car.brand_, car.model_, car.color_);
+        bench::DoNotOptimize(flyweight.shared_state());
+    });
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Flyweight/InternedFlyweight");
+}
@@ -0,0 +1,29 @@
+/**
+ * LockFreeSingleton.cpp: the case of MultithreadedSingletonBench.cpp, plus
+ * the file's function-local static and mutex variants.
+ */
+#define main LockFreeSingletonDemo
+#include "Creational/Singleton/LockFreeSingleton.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+#include <string>
+
+BENCHMARK("Singleton::GetInstance") {
+    const std::string value = "FOO";
+    state.Measure([&] { bench::DoNotOptimize(Singleton::GetInstance(value)); });
+}
+
+BENCHMARK("StaticSingleton::GetInstance") {
+    const std::string value = "FOO";
+    state.Measure([&] { bench::DoNotOptimize(StaticSingleton::GetInstance(value)); });
+}
+
+BENCHMARK("MutexSingleton::GetInstance") {
+    state.Measure([&] { bench::DoNotOptimize(MutexSingleton::GetInstance()); });
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Singleton/LockFreeSingleton");
+}
@@ -0,0 +1,37 @@
+/**
+ * Memento.cpp: a backup and the undo that drops it again, for the 30-byte
+ * state of the demo and for the 64 KiB document of DeltaMemento.cpp. The
+ * baseline of ArenaMementoBench.cpp and DeltaMementoBench.cpp.
+ */
+#define main MementoDemo
+#include "Behavioral/Memento/Memento.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+void BackupAndUndo(bench::State &state, std::string document) {
+    Originator originator(document);
+    Caretaker caretaker(&originator);
+    caretaker.Backup();
+    state.Measure([&] {
+        caretaker.Backup();
+        caretaker.Undo();
+    });
+}
+
+BENCHMARK("Caretaker::Backup+Undo/30B") {
+    BackupAndUndo(state, "Super-duper-super-puper-super.");
+}
+
+BENCHMARK("Caretaker::Backup+Undo/64KiB") {
+    std::string document;
+    while (document.size() < 64 * 1024) {
+        document += "Super-duper-super-puper-super. ";
+    }
+    document.resize(64 * 1024);
+    BackupAndUndo(state, document);
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Memento/Memento");
+}
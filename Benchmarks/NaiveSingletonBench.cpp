@@ -0,0 +1,19 @@
+/**
+ * NaiveSingleton.cpp: getting the instance once it exists.
+ */
+#define main NaiveSingletonDemo
+#include "Creational/Singleton/NaiveSingleton.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+#include <string>
+
+BENCHMARK("Singleton::GetInstance") {
+    const std::string value = "FOO";
+    state.Measure([&] { bench::DoNotOptimize(Singleton::GetInstance(value)); });
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Singleton/NaiveSingleton");
+}
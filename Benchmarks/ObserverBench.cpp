@@ -0,0 +1,48 @@
+/**
+ * Observer.cpp: notifying the attached observers, and attaching and detaching
+ * one. The observers are the pattern's own, so every Update also formats its
+ * line of output.
+ */
+#define main ObserverDemo
+#include "Behavioral/Observer/Observer.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+#include <memory>
+#include <vector>
+
+template <size_t Observers>
+void Notify(bench::State &state) {
+    Subject subject;
+    std::vector<std::unique_ptr<Observer>> observers;
+    for (size_t i = 0; i < Observers; ++i) {
+        observers.push_back(std::make_unique<Observer>(subject));
+    }
+    state.Measure([&] { subject.Notify(); });
+}
+
+BENCHMARK("Subject::Notify/100") {
+    Notify<100>(state);
+}
+
+BENCHMARK("Subject::Notify/10000") {
+    Notify<10000>(state);
+}
+
+BENCHMARK("Subject::Attach+Detach/100") {
+    Subject subject;
+    std::vector<std::unique_ptr<Observer>> observers;
+    for (size_t i = 0; i < 100; ++i) {
+        observers.push_back(std::make_unique<Observer>(subject));
+    }
+    Observer &observer = *observers[50];
+    state.Measure([&] {
+        subject.Detach(&observer);
+        subject.Attach(&observer);
+    });
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Observer/Observer");
+}
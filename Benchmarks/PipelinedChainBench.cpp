@@ -0,0 +1,64 @@
+/**
+ * PipelinedChain.cpp: the case of ResponsibilityChainBench.cpp one request at
+ * a time, then 256 of those requests as one batch, handled on the caller and
+ * sent through the pipeline and back. A batch op is 256 requests.
+ */
+#define main PipelinedChainDemo
+#include "Behavioral/ResponsibilityChain/PipelinedChain.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+const std::string kFood[] = {"Nut", "Banana", "Cup of coffee", "MeatBall"};
+
+struct Chain {
+    Chain() {
+        monkey_.SetNext(&squirrel_)->SetNext(&dog_);
+    }
+    MonkeyHandler monkey_;
+    SquirrelHandler squirrel_;
+    DogHandler dog_;
+};
+
+ChainPipeline::Batch MakeBatch() {
+    ChainPipeline::Batch batch = std::make_unique<RequestBatch>();
+    for (size_t i = 0; i < 256; ++i) {
+        batch->Add(kFood[i % 4]);
+    }
+    return batch;
+}
+
+BENCHMARK("Handler::Handle/3") {
+    Chain chain;
+    size_t i = 0;
+    state.Measure([&] {
+        std::string result = chain.monkey_.Handle(kFood[i++ % 4]);
+        bench::DoNotOptimize(result.size());
+    });
+}
+
+BENCHMARK("Handler::HandleBatch/256") {
+    Chain chain;
+    ChainPipeline::Batch batch = MakeBatch();
+    state.Measure([&] {
+        batch->Rewind();
+        chain.monkey_.HandleBatch(*batch);
+    });
+}
+
+BENCHMARK("ChainPipeline::Submit+Receive/256") {
+    Chain chain;
+    ChainPipeline pipeline(chain.monkey_);
+    ChainPipeline::Batch batch = MakeBatch();
+    state.Measure([&] {
+        batch->Rewind();
+        pipeline.Submit(std::move(batch));
+        batch = pipeline.Receive();
+    });
+    pipeline.Close();
+    bench::DoNotOptimize(pipeline.Receive());
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "ResponsibilityChain/PipelinedChain");
+}
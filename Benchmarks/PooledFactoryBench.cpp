@@ -0,0 +1,46 @@
+/**
+ * PooledFactory.cpp: the CreateSingleObject case of ExtensibleFactoryBench.cpp
+ * on the frozen registry, by name and by a handle resolved once. The object
+ * goes back to its pool.
+ */
+#define main PooledFactoryDemo
+#include "Creational/ExtensibleFactory/PooledFactory.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+/**
+ * The registry is global and can be frozen only once, so every case shares
+ * the same registration.
+ */
+void RegisterTypes() {
+    if (!GameObjectFactory::IsFrozen()) {
+        GameObjectFactory::RegisterObject<Plane>("plane");
+        GameObjectFactory::RegisterObject<Boat>("boat");
+        GameObjectFactory::RegisterObject<Ant>("ant");
+        GameObjectFactory::Freeze();
+    }
+}
+
+BENCHMARK("GameObjectFactory::CreateSingleObject+DestroyObject") {
+    RegisterTypes();
+    state.Measure([&] {
+        IGameObject *object = GameObjectFactory::CreateSingleObject(std::string_view("boat"));
+        bench::DoNotOptimize(object);
+        GameObjectFactory::DestroyObject(object);
+    });
+}
+
+BENCHMARK("GameObjectFactory::CreateSingleObject+DestroyObject/TypeHandle") {
+    RegisterTypes();
+    GameObjectFactory::TypeHandle boat = GameObjectFactory::Resolve("boat");
+    state.Measure([&] {
+        IGameObject *object = GameObjectFactory::CreateSingleObject(boat);
+        bench::DoNotOptimize(object);
+        GameObjectFactory::DestroyObject(object);
+    });
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "ExtensibleFactory/PooledFactory");
+}
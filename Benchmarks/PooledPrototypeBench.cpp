@@ -0,0 +1,30 @@
+/**
+ * PooledPrototype.cpp: the case of PrototypeBench.cpp, where the handle gives
+ * the object back to the pool, and the unpooled clone for comparison.
+ */
+#define main PooledPrototypeDemo
+#include "Creational/Prototype/PooledPrototype.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+BENCHMARK("PrototypeFactory::CreatePrototype") {
+    PrototypeFactory factory;
+    state.Measure([&] {
+        PooledPrototype prototype = factory.CreatePrototype(Type::PROTOTYPE_1);
+        bench::DoNotOptimize(prototype.get());
+    });
+}
+
+BENCHMARK("PrototypeFactory::ClonePrototype") {
+    PrototypeFactory factory;
+    state.Measure([&] {
+        Prototype *prototype = factory.ClonePrototype(Type::PROTOTYPE_1);
+        bench::DoNotOptimize(prototype);
+        delete prototype;
+    });
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Prototype/PooledPrototype");
+}
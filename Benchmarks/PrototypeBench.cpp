@@ -0,0 +1,22 @@
+/**
+ * Prototype.cpp: cloning a prototype through the factory and deleting the
+ * clone.
+ */
+#define main PrototypeDemo
+#include "Creational/Prototype/Prototype.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+BENCHMARK("PrototypeFactory::CreatePrototype") {
+    PrototypeFactory factory;
+    state.Measure([&] {
+        Prototype *prototype = factory.CreatePrototype(Type::PROTOTYPE_1);
+        bench::DoNotOptimize(prototype);
+        delete prototype;
+    });
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Prototype/Prototype");
+}
@@ -0,0 +1,25 @@
+/**
+ * Proxy.cpp: a request to the real subject and the same request through the
+ * proxy, which checks and logs on every call. Everything prints to std::cout,
+ * which the benchmarks discard. The baseline of CachingProxyBench.cpp.
+ */
+#define main ProxyDemo
+#include "Structural/Proxy/Proxy.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+BENCHMARK("RealSubject::Request") {
+    RealSubject real_subject;
+    state.Measure([&] { ClientCode(real_subject); });
+}
+
+BENCHMARK("Proxy::Request") {
+    RealSubject real_subject;
+    Proxy proxy(&real_subject);
+    state.Measure([&] { ClientCode(proxy); });
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Proxy/Proxy");
+}
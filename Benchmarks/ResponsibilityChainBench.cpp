@@ -0,0 +1,27 @@
+/**
+ * ResponsibilityChain.cpp: requests through the Monkey > Squirrel > Dog chain,
+ * taking turns between the three handlers and one request nobody takes. The
+ * baseline of CompiledChainBench.cpp and PipelinedChainBench.cpp.
+ */
+#define main ResponsibilityChainDemo
+#include "Behavioral/ResponsibilityChain/ResponsibilityChain.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+BENCHMARK("Handler::Handle/3") {
+    MonkeyHandler monkey;
+    SquirrelHandler squirrel;
+    DogHandler dog;
+    monkey.SetNext(&squirrel)->SetNext(&dog);
+    const std::string food[] = {"Nut", "Banana", "Cup of coffee", "MeatBall"};
+    size_t i = 0;
+    state.Measure([&] {
+        std::string result = monkey.Handle(food[i++ % 4]);
+        bench::DoNotOptimize(result.size());
+    });
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "ResponsibilityChain/ResponsibilityChain");
+}
@@ -0,0 +1,36 @@
+/**
+ * ReusableBuilder.cpp: the case of BuilderBench.cpp, handing the product over
+ * into one the client keeps reusing, and moving it out by value.
+ */
+#define main ReusableBuilderDemo
+#include "Creational/Builder/ReusableBuilder.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+BENCHMARK("Director::BuildFullFeaturedProduct+GetProduct") {
+    ConcreteBuilder1 builder;
+    Director director;
+    director.set_builder(&builder);
+    Product1 product;
+    state.Measure([&] {
+        director.BuildFullFeaturedProduct();
+        builder.GetProduct(product);
+        bench::DoNotOptimize(product.parts_.size());
+    });
+}
+
+BENCHMARK("Director::BuildFullFeaturedProduct+GetProduct/by value") {
+    ConcreteBuilder1 builder;
+    Director director;
+    director.set_builder(&builder);
+    state.Measure([&] {
+        director.BuildFullFeaturedProduct();
+        Product1 product = builder.GetProduct();
+        bench::DoNotOptimize(product.parts_.size());
+    });
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Builder/ReusableBuilder");
+}
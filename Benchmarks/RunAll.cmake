@@ -0,0 +1,34 @@
+# Runs every benchmark and appends its results to OUTPUT. The file keeps the
+# results of earlier runs, and each line records the revision and build it
+# came from, so runs of different builds and revisions can be compared.
+#
+#   cmake -DBENCHMARKS="a|b" -DOUTPUT=file.jsonl [-DMIN_TIME=0.2] [-DSOURCE_DIR=dir] -P RunAll.cmake
+
+if(NOT BENCHMARKS OR NOT OUTPUT)
+  message(FATAL_ERROR "usage: cmake -DBENCHMARKS=\"a|b\" -DOUTPUT=file.jsonl [-DMIN_TIME=0.2] [-DSOURCE_DIR=dir] -P RunAll.cmake")
+endif()
+if(NOT MIN_TIME)
+  set(MIN_TIME 0.2)
+endif()
+
+set(revision "")
+if(SOURCE_DIR)
+  find_package(Git QUIET)
+  if(GIT_FOUND)
+    execute_process(COMMAND "${GIT_EXECUTABLE}" describe --always --dirty
+      WORKING_DIRECTORY "${SOURCE_DIR}"
+      OUTPUT_VARIABLE revision
+      OUTPUT_STRIP_TRAILING_WHITESPACE
+      ERROR_QUIET)
+  endif()
+endif()
+
+string(REPLACE "|" ";" benchmarks "${BENCHMARKS}")
+foreach(benchmark IN LISTS benchmarks)
+  execute_process(COMMAND "${benchmark}" --json "${OUTPUT}" --min-time "${MIN_TIME}" --revision "${revision}"
+    RESULT_VARIABLE result)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${benchmark} failed: ${result}")
+  endif()
+endforeach()
+message(STATUS "Results appended to ${OUTPUT}")
@@ -0,0 +1,26 @@
+/**
+ * Singleton.cpp: adding a message to the logger, the baseline of
+ * AsyncLoggerBench.cpp. The log is cleared every 1024 messages so a long run
+ * doesn't grow it without bound; the clearing is part of the cost.
+ */
+#define main SingletonDemo
+#include "Creational/Singleton/Singleton.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+BENCHMARK("Logger::addMessage") {
+    Logger &logger = Logger::GetInstance();
+    size_t added = 0;
+    state.Measure([&] {
+        logger.addMessage("worker 1 message 1000");
+        if (++added % 1024 == 0) {
+            logger.clearMessages();
+        }
+    });
+    logger.clearMessages();
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Singleton/Singleton");
+}
@@ -0,0 +1,71 @@
+/**
+ * SinkDecorator.cpp: the chains of DecoratorBench.cpp appending to one reused
+ * buffer, the sixteen-deep chain also as a string of its own, and the same
+ * stack composed at compile time.
+ */
+#define main SinkDecoratorDemo
+#include "Structural/Decorator/SinkDecorator.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+template <size_t Depth>
+struct Chain {
+    Chain() {
+        for (size_t i = 0; i < Depth; ++i) {
+            Component *inner = i == 0 ? static_cast<Component *>(&simple_) : chain_.back().get();
+            if (i % 2 == 0) {
+                chain_.push_back(std::make_unique<ConcreteDecoratorA>(inner));
+            } else {
+                chain_.push_back(std::make_unique<ConcreteDecoratorB>(inner));
+            }
+        }
+    }
+    const Component &top() const {
+        return *chain_.back();
+    }
+    ConcreteComponent simple_;
+    std::vector<std::unique_ptr<Component>> chain_;
+};
+
+template <size_t Depth>
+void Operation(bench::State &state) {
+    Chain<Depth> chain;
+    std::string out;
+    out.reserve(chain.top().Length());
+    state.Measure([&] {
+        out.clear();
+        chain.top().Operation(out);
+        bench::DoNotOptimize(out.data());
+    });
+}
+
+BENCHMARK("Component::Operation/2") {
+    Operation<2>(state);
+}
+
+BENCHMARK("Component::Operation/16") {
+    Operation<16>(state);
+}
+
+BENCHMARK("Component::Result/16") {
+    Chain<16> chain;
+    state.Measure([&] {
+        std::string result = chain.top().Result();
+        bench::DoNotOptimize(result.data());
+    });
+}
+
+BENCHMARK("Decorated<...>::Operation/16") {
+    Stack16 fixed;
+    std::string out;
+    state.Measure([&] {
+        out.clear();
+        fixed.Operation(out);
+        bench::DoNotOptimize(out.data());
+    });
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Decorator/SinkDecorator");
+}
@@ -0,0 +1,75 @@
+/**
+ * SnapshotObserver.cpp: the cases of ObserverBench.cpp, plus publishing typed
+ * events to plain callbacks.
+ */
+#define main SnapshotObserverDemo
+#include "Behavioral/Observer/SnapshotObserver.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+#include <memory>
+#include <vector>
+
+template <size_t Observers>
+void Notify(bench::State &state) {
+    Subject subject;
+    std::vector<std::unique_ptr<Observer>> observers;
+    for (size_t i = 0; i < Observers; ++i) {
+        observers.push_back(std::make_unique<Observer>(subject));
+    }
+    state.Measure([&] { subject.Notify(); });
+}
+
+template <size_t Observers>
+void Publish(bench::State &state) {
+    TypedSubject<PriceTick> ticker;
+    std::vector<PriceCounter> counters(Observers);
+    for (PriceCounter &counter : counters) {
+        ticker.Attach<PriceCounter, &PriceCounter::OnTick>(&counter);
+    }
+    PriceTick tick{7, 101.5};
+    state.Measure([&] {
+        ticker.Publish(tick);
+        tick.price_ += 0.25;
+    });
+    bench::DoNotOptimize(counters.back().ticks_);
+}
+
+BENCHMARK("Subject::Notify/100") {
+    Notify<100>(state);
+}
+
+BENCHMARK("Subject::Notify/10000") {
+    Notify<10000>(state);
+}
+
+/**
+ * The next Notify rebuilds the snapshot, so this also measures that.
+ */
+BENCHMARK("Subject::Attach+Detach/100") {
+    Subject subject;
+    std::vector<std::unique_ptr<Observer>> observers;
+    for (size_t i = 0; i < 100; ++i) {
+        observers.push_back(std::make_unique<Observer>(subject));
+    }
+    Observer &observer = *observers[50];
+    observer.RemoveMeFromTheList();
+    state.Measure([&] {
+        ObserverHandle handle = subject.Attach(&observer);
+        subject.Detach(handle);
+        subject.Notify();
+    });
+}
+
+BENCHMARK("TypedSubject::Publish/100") {
+    Publish<100>(state);
+}
+
+BENCHMARK("TypedSubject::Publish/10000") {
+    Publish<10000>(state);
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Observer/SnapshotObserver");
+}
@@ -0,0 +1,26 @@
+/**
+ * State.cpp: a pair of requests that takes the context from A to B and back,
+ * and a transition on its own. Each of them also prints its trace.
+ */
+#define main StateDemo
+#include "Behavioral/State/State.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+BENCHMARK("Context::Request1+Request2") {
+    Context context(new ConcreteStateA);
+    state.Measure([&] {
+        context.Request1();
+        context.Request2();
+    });
+}
+
+BENCHMARK("Context::TransitionTo") {
+    Context context(new ConcreteStateA);
+    state.Measure([&] { context.TransitionTo(new ConcreteStateA); });
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "State/State");
+}
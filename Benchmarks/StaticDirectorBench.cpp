@@ -0,0 +1,33 @@
+/**
+ * StaticDirector.cpp: the reusing case of ReusableBuilderBench.cpp through the
+ * runtime Director, and the same product built by the compile-time recipe.
+ */
+#define main StaticDirectorDemo
+#include "Creational/Builder/StaticDirector.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+BENCHMARK("RuntimeDirector::BuildFullFeaturedProduct+GetProduct") {
+    ConcreteBuilder1 builder;
+    RuntimeDirector director;
+    director.set_builder(&builder);
+    Product1 product;
+    state.Measure([&] {
+        director.BuildFullFeaturedProduct();
+        builder.GetProduct(product);
+        bench::DoNotOptimize(product.parts_.size());
+    });
+}
+
+BENCHMARK("FullFeaturedProduct<FixedBuilder1>::Build") {
+    FixedBuilder1 builder;
+    state.Measure([&] {
+        FullFeaturedProduct<FixedBuilder1>::Product product = FullFeaturedProduct<FixedBuilder1>::Build(builder);
+        bench::DoNotOptimize(product.parts_);
+    });
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Builder/StaticDirector");
+}
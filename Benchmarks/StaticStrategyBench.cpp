@@ -0,0 +1,30 @@
+/**
+ * StaticStrategy.cpp: the five-letter case of StrategyBench.cpp through the
+ * runtime context and through the context that takes the strategy as a
+ * template argument.
+ */
+#define main StaticStrategyDemo
+#include "Behavioral/Strategy/StaticStrategy.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+template <typename ContextT>
+void DoAlgorithm(bench::State &state, const ContextT &context) {
+    state.Measure([&] {
+        std::string result = context.doAlgorithm("aecbd");
+        bench::DoNotOptimize(result.data());
+    });
+}
+
+BENCHMARK("RuntimeContext::doAlgorithm/5") {
+    DoAlgorithm(state, RuntimeContext(std::make_unique<ConcreteStrategyA>()));
+}
+
+BENCHMARK("Context<ConcreteStrategyA>::doAlgorithm/5") {
+    DoAlgorithm(state, Context<ConcreteStrategyA>());
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Strategy/StaticStrategy");
+}
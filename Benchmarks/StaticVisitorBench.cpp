@@ -0,0 +1,61 @@
+/**
+ * StaticVisitor.cpp: the case of VisitorBench.cpp, then the same components
+ * in a vector of variants and grouped by type.
+ */
+#define main StaticVisitorDemo
+#include "Behavioral/Visitor/StaticVisitor.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+struct Components {
+    std::vector<std::unique_ptr<Component>> owned_;
+    std::vector<const Component *> pointers_;
+    std::vector<AnyComponent> values_;
+    ComponentStore grouped_;
+
+    explicit Components(size_t count) {
+        std::mt19937 random(42);
+        for (size_t i = 0; i < count; ++i) {
+            int value = static_cast<int>(random() % 1000);
+            if (random() % 2) {
+                this->owned_.push_back(std::make_unique<ConcreteComponentA>(value));
+                this->values_.emplace_back(ConcreteComponentA(value));
+            } else {
+                this->owned_.push_back(std::make_unique<ConcreteComponentB>(value));
+                this->values_.emplace_back(ConcreteComponentB(value));
+            }
+            this->pointers_.push_back(this->owned_.back().get());
+            this->grouped_.Add(this->values_.back());
+        }
+    }
+};
+
+BENCHMARK("Component::Accept/1000") {
+    Components components(1000);
+    ChecksumVisitor visitor;
+    state.Measure([&] { ClientCode(components.pointers_, &visitor); });
+    bench::DoNotOptimize(visitor.sum_a_ + visitor.sum_b_);
+}
+
+BENCHMARK("std::visit/1000") {
+    Components components(1000);
+    ChecksumVisitor visitor;
+    state.Measure([&] { StaticClientCode(components.values_, visitor); });
+    bench::DoNotOptimize(visitor.sum_a_ + visitor.sum_b_);
+}
+
+BENCHMARK("ComponentStore::VisitAll/1000") {
+    Components components(1000);
+    ChecksumVisitor visitor;
+    state.Measure([&] { components.grouped_.VisitAll(visitor); });
+    bench::DoNotOptimize(visitor.sum_a_ + visitor.sum_b_);
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Visitor/StaticVisitor");
+}
@@ -0,0 +1,45 @@
+/**
+ * Strategy.cpp: sorting through the Strategy interface, for the five letters
+ * of the demo and for random bytes. The baseline of StaticStrategyBench.cpp
+ * and ByteSortStrategyBench.cpp.
+ */
+#define main StrategyDemo
+#include "Behavioral/Strategy/Strategy.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+#include <random>
+
+std::string RandomBytes(size_t size) {
+    std::mt19937_64 random(1);
+    std::string bytes(size, '\0');
+    for (char &c : bytes) {
+        c = static_cast<char>(random());
+    }
+    return bytes;
+}
+
+void DoAlgorithm(bench::State &state, const std::string &data) {
+    std::unique_ptr<Strategy> strategy = std::make_unique<ConcreteStrategyA>();
+    state.Measure([&] {
+        std::string result = strategy->doAlgorithm(data);
+        bench::DoNotOptimize(result.data());
+    });
+}
+
+BENCHMARK("Strategy::doAlgorithm/5") {
+    DoAlgorithm(state, "aecbd");
+}
+
+BENCHMARK("Strategy::doAlgorithm/64KiB") {
+    DoAlgorithm(state, RandomBytes(64 << 10));
+}
+
+BENCHMARK("Strategy::doAlgorithm/4MiB") {
+    DoAlgorithm(state, RandomBytes(4 << 20));
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Strategy/Strategy");
+}
@@ -0,0 +1,69 @@
+/**
+ * TableState.cpp: the cases of StateBench.cpp for each of the file's
+ * contexts. The plain cases print the same trace as State.cpp; the "/quiet"
+ * ones switch it off, as the file's own benchmark does.
+ */
+#define main TableStateDemo
+#include "Behavioral/State/TableState.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+template <typename ContextT>
+void Requests(bench::State &state, ContextT &context, bool quiet) {
+    g_Log = quiet ? nullptr : &std::cout;
+    state.Measure([&] {
+        context.Request1();
+        context.Request2();
+    });
+    g_Log = &std::cout;
+}
+
+BENCHMARK("HeapContext::Request1+Request2") {
+    HeapContext context(new HeapStateA);
+    Requests(state, context, false);
+}
+
+BENCHMARK("PreallocatedContext::Request1+Request2") {
+    PreallocatedContext context(StateId::A);
+    Requests(state, context, false);
+}
+
+BENCHMARK("TableContext::Request1+Request2") {
+    TableContext context(StateId::A);
+    Requests(state, context, false);
+}
+
+BENCHMARK("HeapContext::Request1+Request2/quiet") {
+    HeapContext context(new HeapStateA);
+    Requests(state, context, true);
+}
+
+BENCHMARK("PreallocatedContext::Request1+Request2/quiet") {
+    PreallocatedContext context(StateId::A);
+    Requests(state, context, true);
+}
+
+BENCHMARK("TableContext::Request1+Request2/quiet") {
+    TableContext context(StateId::A);
+    Requests(state, context, true);
+}
+
+BENCHMARK("HeapContext::TransitionTo") {
+    HeapContext context(new HeapStateA);
+    state.Measure([&] { context.TransitionTo(new HeapStateA); });
+}
+
+BENCHMARK("PreallocatedContext::TransitionTo") {
+    PreallocatedContext context(StateId::A);
+    StateId next = StateId::B;
+    state.Measure([&] {
+        context.TransitionTo(next);
+        next = next == StateId::A ? StateId::B : StateId::A;
+    });
+    bench::DoNotOptimize(context.state());
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "State/TableState");
+}
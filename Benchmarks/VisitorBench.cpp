@@ -0,0 +1,45 @@
+/**
+ * Visitor.cpp: double dispatch over 1000 components of both classes, in
+ * random order. The visitor does a little work per element instead of
+ * printing.
+ */
+#define main VisitorDemo
+#include "Behavioral/Visitor/Visitor.cpp"
+#undef main
+
+#include "Benchmark.h"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+class CountingVisitor : public Visitor {
+public:
+    void VisitConcreteComponentA(const ConcreteComponentA *element) const override {
+        count_a_ += element->ExclusiveMethodOfConcreteComponentA().size();
+    }
+    void VisitConcreteComponentB(const ConcreteComponentB *element) const override {
+        count_b_ += element->SpecialMethodOfConcreteComponentB().size();
+    }
+    mutable size_t count_a_ = 0;
+    mutable size_t count_b_ = 0;
+};
+
+BENCHMARK("Component::Accept/1000") {
+    std::mt19937 random(42);
+    std::vector<std::unique_ptr<Component>> components;
+    for (size_t i = 0; i < 1000; ++i) {
+        components.push_back(random() % 2 ? std::unique_ptr<Component>(new ConcreteComponentA) : std::unique_ptr<Component>(new ConcreteComponentB));
+    }
+    CountingVisitor visitor;
+    state.Measure([&] {
+        for (const std::unique_ptr<Component> &component : components) {
+            component->Accept(&visitor);
+        }
+    });
+    bench::DoNotOptimize(visitor.count_a_ + visitor.count_b_);
+}
+
+int main(int argc, char **argv) {
+    return bench::Main(argc, argv, "Visitor/Visitor");
+}
@@ -0,0 +1,60 @@
+/**
+ * Counts heap allocations, for the pattern files and benchmarks that show
+ * what an allocation-free variant saves.
+ *
+ * Including this header replaces the global operator new and delete, the
+ * aligned forms included, with versions that count every allocation in
+ * g_HeapAllocations. Replacement functions can't be inline, so every program
+ * includes it from exactly one translation unit: the pattern file, or the
+ * benchmark that includes it.
+ */
+#ifndef COMMON_HEAP_ALLOCATIONS_H
+#define COMMON_HEAP_ALLOCATIONS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+inline std::atomic<size_t> g_HeapAllocations{0};
+
+void *operator new(size_t size) {
+    g_HeapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+// The standard memory resources allocate through the aligned forms
+void *operator new(size_t size, std::align_val_t alignment) {
+    g_HeapAllocations.fetch_add(1, std::memory_order_relaxed);
+    size_t align = static_cast<size_t>(alignment);
+    if (void *p = std::aligned_alloc(align, (size + align - 1) / align * align)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+// GCC sees the free() of inlined deletes pair up with these operator news and
+// wrongly reports a mismatch.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+void operator delete(void *p, size_t) noexcept {
+    std::free(p);
+}
+void operator delete(void *p, std::align_val_t) noexcept {
+    std::free(p);
+}
+void operator delete(void *p, size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
@@ -0,0 +1,378 @@
+/**
+ * Abstract Factory that creates whole product families in one block.
+ *
+ * The products of a family are used together: B collaborates with A. Created
+ * one `new` at a time, the two can end up anywhere on the heap, so using a
+ * pair costs two cache misses where one would do. CreateFamilies(n) builds n
+ * matching A+B pairs in a single block, each B right next to its A, and hands
+ * back one owning handle for the lot. The block comes from a
+ * std::pmr::memory_resource chosen when the factory is built, so the caller
+ * decides between the heap, an arena or a pool.
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <memory_resource>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cstddef>
+#include <new>
+#include <limits>
+
+// Counts heap allocations so the demo can show what one block per batch saves.
+#include "../../Common/HeapAllocations.h"
+
+class AbstractProductA {
+public:
+    virtual ~AbstractProductA() {};
+    virtual std::string UsefulFunctionA() const = 0;
+    // A cheap query for hot loops, which UsefulFunctionA()'s string would drown out.
+    virtual int Code() const = 0;
+};
+
+// Concrete Products are created by corresponding Concrete Factories.
+class ConcreteProductA1: public AbstractProductA {
+public:
+    std::string UsefulFunctionA() const override {
+        return "The result of the product A1.";
+    }
+    int Code() const override {
+        return 1;
+    }
+};
+
+class ConcreteProductA2: public AbstractProductA {
+    std::string UsefulFunctionA() const override {
+        return "The result of the product A2.";
+    }
+    int Code() const override {
+        return 2;
+    }
+};
+
+class AbstractProductB {
+public:
+    virtual ~AbstractProductB() {};
+    virtual std::string UsefulFunctionB() const = 0;
+    virtual std::string AnotherUsefulFunctionB(const AbstractProductA &collaborator) const = 0;
+    // The hot-loop counterpart of AnotherUsefulFunctionB(): touches both products.
+    virtual int Combine(const AbstractProductA &collaborator) const = 0;
+};
+
+class ConcreteProductB1: public AbstractProductB {
+public:
+    std::string UsefulFunctionB() const override {
+        return "The result of the product B1.";
+    }
+   std::string AnotherUsefulFunctionB(const AbstractProductA &collaborator) const override {
+        const std::string result = collaborator.UsefulFunctionA();
+        return "The result of the B1 collaborating with ( " + result + " )";
+   }
+   int Combine(const AbstractProductA &collaborator) const override {
+        return 10 + collaborator.Code();
+   }
+};
+
+class ConcreteProductB2: public AbstractProductB {
+public:
+    std::string UsefulFunctionB() const override {
+        return "The result of the product B2.";
+    }
+   std::string AnotherUsefulFunctionB(const AbstractProductA &collaborator) const override {
+        const std::string result = collaborator.UsefulFunctionA();
+        return "The result of the B2 collaborating with ( " + result + " )";
+   }
+   int Combine(const AbstractProductA &collaborator) const override {
+        return 20 + collaborator.Code();
+   }
+};
+
+/**
+ * An owning handle to n product pairs in one block. Pair i is reached
+ * through A(i) and B(i) without knowing the concrete classes: the handle
+ * points at a Layout, one per pair of concrete classes, with the functions
+ * that do know them. Destroying the handle destroys the products and gives
+ * the block back to its memory resource.
+ */
+class ProductFamilies {
+private:
+    struct Layout {
+        size_t stride_;
+        size_t alignment_;
+        AbstractProductA *(*a_)(std::byte *);
+        AbstractProductB *(*b_)(std::byte *);
+        void (*destroy_)(std::byte *, size_t);
+    };
+
+    template <typename A, typename B>
+    struct Pair {
+        A a_;
+        B b_;
+
+        static constexpr Layout kLayout = {
+            sizeof(Pair), alignof(Pair),
+            [](std::byte *p) -> AbstractProductA * { return &reinterpret_cast<Pair *>(p)->a_; },
+            [](std::byte *p) -> AbstractProductB * { return &reinterpret_cast<Pair *>(p)->b_; },
+            [](std::byte *p, size_t n) {
+                for (size_t i = 0; i < n; ++i) {
+                    reinterpret_cast<Pair *>(p + i * sizeof(Pair))->~Pair();
+                }
+            },
+        };
+    };
+
+    std::pmr::memory_resource *resource_ = nullptr;
+    std::byte *data_ = nullptr;
+    size_t size_ = 0;
+    const Layout *layout_ = nullptr;
+
+public:
+    ProductFamilies() {}
+    ProductFamilies(ProductFamilies &&other) noexcept {
+        *this = std::move(other);
+    }
+    ProductFamilies &operator=(ProductFamilies &&other) noexcept {
+        if (this != &other) {
+            this->Release();
+            std::swap(this->resource_, other.resource_);
+            std::swap(this->data_, other.data_);
+            std::swap(this->size_, other.size_);
+            std::swap(this->layout_, other.layout_);
+        }
+        return *this;
+    }
+    ~ProductFamilies() {
+        this->Release();
+    }
+
+    /**
+     * Builds `count` pairs of A and B in one allocation from `resource`.
+     * Returns no families if `count` pairs wouldn't fit in the address space.
+     */
+    template <typename A, typename B>
+    static ProductFamilies Create(size_t count, std::pmr::memory_resource *resource) {
+        using P = Pair<A, B>;
+        ProductFamilies families;
+        if (count == 0 || count > std::numeric_limits<size_t>::max() / sizeof(P)) {
+            return families;
+        }
+        families.resource_ = resource;
+        families.layout_ = &P::kLayout;
+        families.data_ = static_cast<std::byte *>(resource->allocate(count * sizeof(P), alignof(P)));
+        for (size_t i = 0; i < count; ++i) {
+            new (families.data_ + i * sizeof(P)) P();
+        }
+        families.size_ = count;
+        return families;
+    }
+
+    size_t size() const {
+        return this->size_;
+    }
+    const AbstractProductA &A(size_t i) const {
+        return *this->layout_->a_(this->data_ + i * this->layout_->stride_);
+    }
+    const AbstractProductB &B(size_t i) const {
+        return *this->layout_->b_(this->data_ + i * this->layout_->stride_);
+    }
+
+private:
+    void Release() {
+        if (this->data_ != nullptr) {
+            this->layout_->destroy_(this->data_, this->size_);
+            this->resource_->deallocate(this->data_, this->size_ * this->layout_->stride_, this->layout_->alignment_);
+            this->data_ = nullptr;
+            this->size_ = 0;
+        }
+    }
+};
+
+/*
+    The Abstract Factory interface declares a set of methods that return different abstract products. Besides the
+    single products it can now create whole families: CreateFamily() for one matching pair, CreateFamilies(n) for n.
+*/
+class AbstractFactory {
+protected:
+    std::pmr::memory_resource *resource_;
+public:
+    explicit AbstractFactory(std::pmr::memory_resource *resource = std::pmr::get_default_resource()) : resource_(resource) {}
+    virtual ~AbstractFactory() {}
+    virtual AbstractProductA *CreateProductA() const = 0;
+    virtual AbstractProductB *CreateProductB() const = 0;
+    virtual ProductFamilies CreateFamilies(size_t count) const = 0;
+
+    ProductFamilies CreateFamily() const {
+        return this->CreateFamilies(1);
+    }
+};
+
+class ConcreteFactory1: public AbstractFactory {
+public:
+    using AbstractFactory::AbstractFactory;
+    AbstractProductA *CreateProductA() const override {
+        return new ConcreteProductA1();
+    }
+    AbstractProductB *CreateProductB() const override {
+        return new ConcreteProductB1();
+    }
+    ProductFamilies CreateFamilies(size_t count) const override {
+        return ProductFamilies::Create<ConcreteProductA1, ConcreteProductB1>(count, this->resource_);
+    }
+};
+
+class ConcreteFactory2: public AbstractFactory {
+public:
+    using AbstractFactory::AbstractFactory;
+    AbstractProductA *CreateProductA() const override {
+        return new ConcreteProductA2();
+    }
+    AbstractProductB *CreateProductB() const override {
+        return new ConcreteProductB2();
+    }
+    ProductFamilies CreateFamilies(size_t count) const override {
+        return ProductFamilies::Create<ConcreteProductA2, ConcreteProductB2>(count, this->resource_);
+    }
+};
+
+void ClientCode(const AbstractFactory &factory) {
+    ProductFamilies family = factory.CreateFamily();
+    std::cout << family.B(0).UsefulFunctionB() << "\n";
+    std::cout << family.B(0).AnotherUsefulFunctionB(family.A(0)) << "\n";
+}
+
+/**
+ * Uses pairs in a shuffled order, so each pair is a fresh trip to memory. What
+ * decides the speed is how many cache lines a pair spans.
+ */
+template <typename GetA, typename GetB>
+double TimeVisits(const std::vector<size_t> &order, GetA a, GetB b, long &checksum) {
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i : order) {
+        checksum += b(i).Combine(a(i));
+    }
+    auto time = std::chrono::steady_clock::now() - begin;
+    return std::chrono::duration<double, std::nano>(time).count() / order.size();
+}
+
+struct PathResult {
+    double create_ms_;
+    size_t allocations_;
+    double visit_ns_;
+};
+
+template <typename Create, typename Visit>
+PathResult Measure(Create create, Visit visit) {
+    size_t allocations = g_HeapAllocations;
+    auto begin = std::chrono::steady_clock::now();
+    create();
+    PathResult result;
+    result.create_ms_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    result.allocations_ = g_HeapAllocations - allocations;
+    result.visit_ns_ = visit();
+    return result;
+}
+
+/**
+ * The current path, on a heap that other work uses in between. The other
+ * work's allocations are left out of the count.
+ */
+PathResult SingleProducts(const AbstractFactory &factory, const std::vector<size_t> &order, long &checksum) {
+    size_t pairs = order.size();
+    std::vector<const AbstractProductA *> products_a(pairs);
+    std::vector<const AbstractProductB *> products_b(pairs);
+    std::vector<std::unique_ptr<char[]>> other_work;
+    other_work.reserve(2 * pairs);
+    std::mt19937 random(2);
+    PathResult result = Measure([&] {
+        for (size_t i = 0; i < pairs; ++i) {
+            products_a[i] = factory.CreateProductA();
+            other_work.emplace_back(new char[16 + random() % 128]);
+            products_b[i] = factory.CreateProductB();
+            other_work.emplace_back(new char[16 + random() % 128]);
+        }
+    }, [&] {
+        return TimeVisits(order, [&](size_t i) -> const AbstractProductA & { return *products_a[i]; },
+                          [&](size_t i) -> const AbstractProductB & { return *products_b[i]; }, checksum);
+    });
+    result.allocations_ -= other_work.size();
+    for (size_t i = 0; i < pairs; ++i) {
+        delete products_a[i];
+        delete products_b[i];
+    }
+    return result;
+}
+
+PathResult Batch(const AbstractFactory &factory, const std::vector<size_t> &order, long &checksum) {
+    ProductFamilies families;
+    return Measure([&] { families = factory.CreateFamilies(order.size()); }, [&] {
+        return TimeVisits(order, [&](size_t i) -> const AbstractProductA & { return families.A(i); },
+                          [&](size_t i) -> const AbstractProductB & { return families.B(i); }, checksum);
+    });
+}
+
+/**
+ * One family at a time, from an arena that the caller owns. Every family has
+ * a handle of its own, and in random order the handles cost a miss too.
+ */
+PathResult OneByOne(const std::vector<size_t> &order, long &checksum) {
+    size_t pairs = order.size();
+    std::pmr::monotonic_buffer_resource arena(pairs * 2 * sizeof(ConcreteProductA1) + 4096);
+    ConcreteFactory1 factory(&arena);
+    std::vector<ProductFamilies> families;
+    families.reserve(pairs);
+    return Measure([&] {
+        for (size_t i = 0; i < pairs; ++i) {
+            families.push_back(factory.CreateFamily());
+        }
+    }, [&] {
+        return TimeVisits(order, [&](size_t i) -> const AbstractProductA & { return families[i].A(0); },
+                          [&](size_t i) -> const AbstractProductB & { return families[i].B(0); }, checksum);
+    });
+}
+
+void Print(const char *name, const PathResult &result) {
+    std::cout << name << "create " << result.create_ms_ << " ms, " << result.allocations_ << " allocations, "
+              << result.visit_ns_ << " ns per pair used\n";
+}
+
+std::vector<size_t> ShuffledOrder(size_t size) {
+    std::vector<size_t> order(size);
+    for (size_t i = 0; i < size; ++i) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937(1));
+    return order;
+}
+
+void Benchmark() {
+    const size_t pairs = 1000000;
+    const std::vector<size_t> order = ShuffledOrder(pairs);
+    long checksum = 0;
+    ConcreteFactory1 factory;
+    // Freeing the single products leaves millions of small free chunks behind,
+    // which would make the next large allocation slow, so they go last
+    PathResult batch = Batch(factory, order, checksum);
+    PathResult one_by_one = OneByOne(order, checksum);
+    PathResult single = SingleProducts(factory, order, checksum);
+
+    std::cout << "\n" << pairs << " A+B pairs, used in random order (checksum " << checksum << "):\n";
+    Print("  new per product:              ", single);
+    Print("  CreateFamilies(n):            ", batch);
+    Print("  CreateFamily() from an arena: ", one_by_one);
+}
+
+int main() {
+    std::cout << "Client: Testing client code with the first factory type:\n";
+    ConcreteFactory1 f1;
+    ClientCode(f1);
+    std::cout << std::endl;
+    std::cout << "Client: Testing client code with the second factory type:\n";
+    std::pmr::unsynchronized_pool_resource pool;
+    ConcreteFactory2 f2(&pool);
+    ClientCode(f2);
+
+    Benchmark();
+    return 0;
+}
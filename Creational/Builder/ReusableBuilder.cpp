@@ -0,0 +1,228 @@
+/**
+ * A reusable, allocation-free variation of Builder.cpp.
+ *
+ * The product is a value object held directly by the builder. Parts are
+ * string_views of names with static storage, so adding one never builds a
+ * std::string. The part vector keeps its capacity from one product to the
+ * next, and the Director tells the builder up front how many parts a recipe
+ * needs. In steady state, building a product doesn't touch the heap.
+ */
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <chrono>
+
+// Counts heap allocations so the demo can show what reuse saves.
+#include "../../Common/HeapAllocations.h"
+
+/**
+ * The part names. Each product stores views of these instead of copies.
+ */
+namespace Parts {
+constexpr std::string_view A1 = "PartA1";
+constexpr std::string_view B1 = "PartB1";
+constexpr std::string_view C1 = "PartC1";
+}
+
+class Product1 {
+public:
+    std::vector<std::string_view> parts_;
+    void ListParts() const {
+        std::cout << "Product parts: ";
+        for (size_t i=0; i<parts_.size()-1; i++) {
+            std::cout << parts_[i] << ", ";
+        }
+        // print the last part without a comma
+        std::cout << parts_.back() << "\n\n";
+    }
+};
+
+/**
+ * The Builder interface specifies methods for creating the different parts of
+ * the Product objects. Reserve() is a hint about how many parts are coming.
+ */
+class Builder {
+public:
+    virtual ~Builder() {}
+    virtual void Reserve(size_t /* parts */) {}
+    virtual void ProducePartA() = 0;
+    virtual void ProducePartB() = 0;
+    virtual void ProducePartC() = 0;
+};
+
+/**
+ * The Concrete Builder holds the product by value and recycles its storage.
+ */
+class ConcreteBuilder1: public Builder {
+private:
+    Product1 product_;
+public:
+    /**
+     * Starts a new product, keeping the capacity of the previous one.
+     */
+    void Reset() {
+        this->product_.parts_.clear();
+    }
+
+    void Reserve(size_t parts) override {
+        this->product_.parts_.reserve(parts);
+    }
+
+    void ProducePartA() override {
+        this->product_.parts_.push_back(Parts::A1);
+    }
+
+    void ProducePartB() override {
+        this->product_.parts_.push_back(Parts::B1);
+    }
+
+    void ProducePartC() override {
+        this->product_.parts_.push_back(Parts::C1);
+    }
+
+    /**
+     * Moves the finished product out. Its storage leaves with it, so the next
+     * product allocates again unless the Director reserves for it.
+     */
+    Product1 GetProduct() {
+        Product1 result = std::move(this->product_);
+        this->Reset();
+        return result;
+    }
+
+    /**
+     * Hands the finished product over to `out`, taking `out`'s old storage in
+     * exchange. A client that keeps passing the same product back gets each
+     * new product without any allocation.
+     */
+    void GetProduct(Product1& out) {
+        std::swap(out.parts_, this->product_.parts_);
+        this->Reset();
+    }
+};
+
+/**
+ * The Director is only responsible for executing the building steps in a
+ * particular sequence. Since it knows the recipe, it also knows how many parts
+ * each product needs and tells the builder before starting.
+ */
+class Director {
+private:
+    Builder* builder;
+public:
+    static constexpr size_t kMinimalViableParts = 1;
+    static constexpr size_t kFullFeaturedParts = 3;
+
+    void set_builder(Builder* builder) {
+        this->builder = builder;
+    }
+
+    void BuildMinimalViableProduct() {
+        this->builder->Reserve(kMinimalViableParts);
+        this->builder->ProducePartA();
+    }
+
+    void BuildFullFeaturedProduct() {
+        this->builder->Reserve(kFullFeaturedParts);
+        this->builder->ProducePartA();
+        this->builder->ProducePartB();
+        this->builder->ProducePartC();
+    }
+};
+
+/**
+ * The client code creates a builder object, passes it to the director and then
+ * initiates the construction process. The end result is retrieved from the
+ * builder object, by value.
+ */
+void ClientCode(Director& director) {
+    ConcreteBuilder1 builder;
+    director.set_builder(&builder);
+    std::cout << "Standard basic product:\n";
+    director.BuildMinimalViableProduct();
+    builder.GetProduct().ListParts();
+
+    std::cout << "Standard full featured product:\n";
+    director.BuildFullFeaturedProduct();
+    builder.GetProduct().ListParts();
+
+    // Remember, the Builder pattern can be used without a Director class.
+    std::cout << "Custom product:\n";
+    builder.ProducePartA();
+    builder.ProducePartC();
+    builder.GetProduct().ListParts();
+}
+
+/**
+ * The Builder.cpp way: a new product per Reset(), a std::string per part and
+ * no reservation.
+ */
+class HeapBuilder {
+private:
+    struct HeapProduct {
+        std::vector<std::string> parts_;
+    };
+    HeapProduct* product = new HeapProduct();
+public:
+    ~HeapBuilder() {
+        delete product;
+    }
+    void ProducePartA() {
+        this->product->parts_.push_back("PartA1");
+    }
+    void ProducePartB() {
+        this->product->parts_.push_back("PartB1");
+    }
+    void ProducePartC() {
+        this->product->parts_.push_back("PartC1");
+    }
+    size_t Finish() {
+        size_t parts = this->product->parts_.size();
+        delete this->product;
+        this->product = new HeapProduct();
+        return parts;
+    }
+};
+
+int main() {
+    Director director;
+    ClientCode(director);
+
+    const size_t products = 1000000;
+    size_t parts = 0;
+
+    HeapBuilder heap_builder;
+    size_t allocations = g_HeapAllocations;
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < products; ++i) {
+        heap_builder.ProducePartA();
+        heap_builder.ProducePartB();
+        heap_builder.ProducePartC();
+        parts += heap_builder.Finish();
+    }
+    auto heap_time = std::chrono::steady_clock::now() - begin;
+    size_t heap_allocations = g_HeapAllocations - allocations;
+
+    ConcreteBuilder1 builder;
+    director.set_builder(&builder);
+    Product1 product;
+    allocations = g_HeapAllocations;
+    begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < products; ++i) {
+        director.BuildFullFeaturedProduct();
+        builder.GetProduct(product);
+        parts += product.parts_.size();
+    }
+    auto reuse_time = std::chrono::steady_clock::now() - begin;
+    size_t reuse_allocations = g_HeapAllocations - allocations;
+
+    std::cout << "Building " << products << " full featured products (" << parts << " parts in total):\n"
+              << "  new product, std::string parts: "
+              << std::chrono::duration<double, std::nano>(heap_time).count() / products << " ns per product, "
+              << heap_allocations << " allocations\n"
+              << "  reused product, reserved views: "
+              << std::chrono::duration<double, std::nano>(reuse_time).count() / products << " ns per product, "
+              << reuse_allocations << " allocations\n";
+    return 0;
+}
@@ -0,0 +1,237 @@
+/**
+ * Compile-time Director recipes.
+ *
+ * A fixed recipe doesn't need a runtime Builder* and a virtual call per step.
+ * Director<BuilderT, Steps...> lists the steps as types and expands them into
+ * direct calls on the concrete builder, which the compiler can inline. Because
+ * the number of parts is sizeof...(Steps), the product stores them in a
+ * std::array instead of a vector. The runtime Director stays for recipes that
+ * are only known at run time.
+ */
+#include <iostream>
+#include <vector>
+#include <array>
+#include <string_view>
+#include <chrono>
+
+/**
+ * The part names. Products store views of these instead of copies.
+ */
+namespace Parts {
+constexpr std::string_view A1 = "PartA1";
+constexpr std::string_view B1 = "PartB1";
+constexpr std::string_view C1 = "PartC1";
+}
+
+template <typename Container>
+void ListParts(const Container& parts) {
+    std::cout << "Product parts: ";
+    for (size_t i=0; i<parts.size()-1; i++) {
+        std::cout << parts[i] << ", ";
+    }
+    // print the last part without a comma
+    std::cout << parts.back() << "\n\n";
+}
+
+/**
+ * The runtime path, as in ReusableBuilder.cpp.
+ */
+class Product1 {
+public:
+    std::vector<std::string_view> parts_;
+    void ListParts() const {
+        ::ListParts(parts_);
+    }
+};
+
+class Builder {
+public:
+    virtual ~Builder() {}
+    virtual void Reserve(size_t /* parts */) {}
+    virtual void ProducePartA() = 0;
+    virtual void ProducePartB() = 0;
+    virtual void ProducePartC() = 0;
+};
+
+class ConcreteBuilder1: public Builder {
+private:
+    Product1 product_;
+public:
+    void Reserve(size_t parts) override {
+        this->product_.parts_.reserve(parts);
+    }
+    void ProducePartA() override {
+        this->product_.parts_.push_back(Parts::A1);
+    }
+    void ProducePartB() override {
+        this->product_.parts_.push_back(Parts::B1);
+    }
+    void ProducePartC() override {
+        this->product_.parts_.push_back(Parts::C1);
+    }
+    void GetProduct(Product1& out) {
+        std::swap(out.parts_, this->product_.parts_);
+        this->product_.parts_.clear();
+    }
+};
+
+/**
+ * The runtime Director, for recipes chosen while the program runs.
+ */
+class RuntimeDirector {
+private:
+    Builder* builder;
+public:
+    void set_builder(Builder* builder) {
+        this->builder = builder;
+    }
+
+    void BuildMinimalViableProduct() {
+        this->builder->Reserve(1);
+        this->builder->ProducePartA();
+    }
+
+    void BuildFullFeaturedProduct() {
+        this->builder->Reserve(3);
+        this->builder->ProducePartA();
+        this->builder->ProducePartB();
+        this->builder->ProducePartC();
+    }
+};
+
+/**
+ * The compile-time path. A product with exactly N parts.
+ */
+template <size_t N>
+class FixedProduct1 {
+public:
+    std::array<std::string_view, N> parts_;
+    void ListParts() const {
+        ::ListParts(parts_);
+    }
+};
+
+/**
+ * A concrete builder for the compile-time path. It has no virtual methods and
+ * no state: each step returns its part, and the Director places the parts
+ * straight into the product it returns.
+ */
+class FixedBuilder1 {
+public:
+    template <size_t N>
+    using Product = FixedProduct1<N>;
+
+    std::string_view ProducePartA() const {
+        return Parts::A1;
+    }
+    std::string_view ProducePartB() const {
+        return Parts::B1;
+    }
+    std::string_view ProducePartC() const {
+        return Parts::C1;
+    }
+};
+
+/**
+ * Building steps as types. Each one knows which builder method it stands for.
+ */
+struct PartA {
+    template <typename B>
+    static auto Apply(const B& builder) {
+        return builder.ProducePartA();
+    }
+};
+struct PartB {
+    template <typename B>
+    static auto Apply(const B& builder) {
+        return builder.ProducePartB();
+    }
+};
+struct PartC {
+    template <typename B>
+    static auto Apply(const B& builder) {
+        return builder.ProducePartC();
+    }
+};
+
+/**
+ * The Director as a recipe. Build() runs the steps in order (a braced
+ * initializer list is evaluated left to right) into a product sized for
+ * exactly sizeof...(Steps) parts.
+ */
+template <typename BuilderT, typename... Steps>
+class Director {
+public:
+    static constexpr size_t kParts = sizeof...(Steps);
+    using Product = typename BuilderT::template Product<kParts>;
+
+    static Product Build(const BuilderT& builder = BuilderT()) {
+        return Product{{Steps::Apply(builder)...}};
+    }
+};
+
+/**
+ * The two standard recipes, for any builder.
+ */
+template <typename BuilderT>
+using MinimalViableProduct = Director<BuilderT, PartA>;
+template <typename BuilderT>
+using FullFeaturedProduct = Director<BuilderT, PartA, PartB, PartC>;
+
+static_assert(FullFeaturedProduct<FixedBuilder1>::kParts == 3, "the part count is a compile-time constant");
+static_assert(sizeof(FixedProduct1<3>) == 3 * sizeof(std::string_view), "no heap storage");
+
+void ClientCode() {
+    std::cout << "Standard basic product:\n";
+    MinimalViableProduct<FixedBuilder1>::Build().ListParts();
+
+    std::cout << "Standard full featured product:\n";
+    FullFeaturedProduct<FixedBuilder1>::Build().ListParts();
+
+    std::cout << "Custom product:\n";
+    Director<FixedBuilder1, PartA, PartC>::Build().ListParts();
+
+    // A recipe picked at run time still goes through the virtual path
+    std::cout << "Runtime recipe:\n";
+    ConcreteBuilder1 builder;
+    RuntimeDirector director;
+    director.set_builder(&builder);
+    director.BuildFullFeaturedProduct();
+    Product1 product;
+    builder.GetProduct(product);
+    product.ListParts();
+}
+
+int main() {
+    ClientCode();
+
+    const size_t products = 10000000;
+    size_t checksum = 0;
+
+    ConcreteBuilder1 builder;
+    RuntimeDirector director;
+    director.set_builder(&builder);
+    Product1 product;
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < products; ++i) {
+        director.BuildFullFeaturedProduct();
+        builder.GetProduct(product);
+        checksum += product.parts_.size() + product.parts_[i % 3].size();
+    }
+    auto runtime_time = std::chrono::steady_clock::now() - begin;
+
+    FixedBuilder1 fixed_builder;
+    begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < products; ++i) {
+        FullFeaturedProduct<FixedBuilder1>::Product fixed = FullFeaturedProduct<FixedBuilder1>::Build(fixed_builder);
+        checksum += fixed.parts_.size() + fixed.parts_[i % 3].size();
+    }
+    auto static_time = std::chrono::steady_clock::now() - begin;
+
+    std::cout << "Building " << products << " full featured products (checksum " << checksum << "):\n"
+              << "  runtime Director, virtual Builder: "
+              << std::chrono::duration<double, std::nano>(runtime_time).count() / products << " ns per product\n"
+              << "  Director<FixedBuilder1, ...>:      "
+              << std::chrono::duration<double, std::nano>(static_time).count() / products << " ns per product\n";
+    return 0;
+}
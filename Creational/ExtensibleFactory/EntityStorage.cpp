@@ -0,0 +1,344 @@
+// A data-oriented alternative to the game loop in ExtensibleFactory.cpp.
+// There every object is a separate heap allocation behind an IGameObject*, and each frame makes
+// two virtual calls per object, printing each line with std::endl. EntityStorage keeps all
+// objects of one type in their own contiguous std::vector and runs update and render type by
+// type. The concrete classes are final, so those calls are direct and can be inlined. The update
+// phase can be split into ranges and spread over a few worker threads.
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cmath>
+
+class IGameObject {
+public:
+    // Ensure derived classes call the correct destructor
+    virtual ~IGameObject() {}
+
+    virtual void ObjectPlayDefaultAnimation() = 0;
+    virtual void ObjectMoveInGame() = 0;
+    virtual void Update(float dt) = 0;
+    virtual void Render(std::ostream& out) = 0;
+    // Appends this object's line to a frame buffer
+    virtual void Render(std::string& frame) = 0;
+};
+
+class Plane final : public IGameObject {
+public:
+    Plane(float x, float y) : x_(x), y_(y) {}
+    void ObjectPlayDefaultAnimation() {}
+    void ObjectMoveInGame() {}
+    // Planes fly diagonally
+    void Update(float dt) {
+        x_ += 3.0f * dt;
+        y_ += 1.0f * dt;
+    }
+    void Render(std::ostream& out) {
+        out<<"plane"<<std::endl;
+    }
+    void Render(std::string& frame) {
+        frame += "plane\n";
+    }
+    float x() const {
+        return x_;
+    }
+private:
+    float x_, y_;
+};
+
+class Boat final : public IGameObject {
+public:
+    Boat(float x, float y) : x_(x), y_(y) {}
+    void ObjectPlayDefaultAnimation() {}
+    void ObjectMoveInGame() {}
+    // Boats stay on the water line
+    void Update(float dt) {
+        x_ += 2.0f * dt;
+    }
+    void Render(std::ostream& out) {
+        out<<"boat"<<std::endl;
+    }
+    void Render(std::string& frame) {
+        frame += "boat\n";
+    }
+    float x() const {
+        return x_;
+    }
+private:
+    float x_, y_;
+};
+
+class Ant final : public IGameObject {
+public:
+    Ant(float x, float y) : x_(x), y_(y) {}
+    void ObjectPlayDefaultAnimation() {}
+    void ObjectMoveInGame() {}
+    // Ants walk back and forth inside their anthill
+    void Update(float dt) {
+        x_ += 0.5f * dt;
+        if (x_ > 100.0f) {
+            x_ -= 200.0f;
+        }
+    }
+    void Render(std::ostream& out) {
+        out<<"ant"<<std::endl;
+    }
+    void Render(std::string& frame) {
+        frame += "ant\n";
+    }
+    float x() const {
+        return x_;
+    }
+private:
+    float x_, y_;
+};
+
+// A fixed set of threads that run one job, split into `workers` parts, per call to Run().
+// The calling thread takes part 0, so a pool with one worker runs everything inline.
+class FrameWorkers {
+public:
+    explicit FrameWorkers(size_t workers) : workers_(workers == 0 ? 1 : workers) {
+        for (size_t i = 1; i < workers_; ++i) {
+            threads_.emplace_back([this, i] { this->WorkerLoop(i); });
+        }
+    }
+    ~FrameWorkers() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        start_.notify_all();
+        for (std::thread& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    size_t size() const {
+        return workers_;
+    }
+
+    // Calls job(part) for every part in [0, size()) and returns once all of them are done
+    void Run(const std::function<void(size_t)>& job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = &job;
+            pending_ = workers_ - 1;
+            ++generation_;
+        }
+        start_.notify_all();
+        job(0);
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return pending_ == 0; });
+    }
+
+private:
+    void WorkerLoop(size_t part) {
+        size_t seen = 0;
+        for (;;) {
+            const std::function<void(size_t)>* job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+                if (stopping_) {
+                    return;
+                }
+                seen = generation_;
+                job = job_;
+            }
+            (*job)(part);
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--pending_ == 0) {
+                done_.notify_one();
+            }
+        }
+    }
+
+    size_t workers_;
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable start_, done_;
+    const std::function<void(size_t)>* job_ = nullptr;
+    size_t pending_ = 0;
+    size_t generation_ = 0;
+    bool stopping_ = false;
+};
+
+// All live objects, stored by value and grouped by type
+class EntityStorage {
+public:
+    // Creates an object of a registered type; returns false for an unknown one
+    bool Spawn(std::string_view type, float x, float y) {
+        if (type == "plane") {
+            planes_.emplace_back(x, y);
+        } else if (type == "boat") {
+            boats_.emplace_back(x, y);
+        } else if (type == "ant") {
+            ants_.emplace_back(x, y);
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    // Pre-sizes the arrays when the counts per type are known, e.g. from a level's pre-pass
+    void Reserve(size_t planes, size_t boats, size_t ants) {
+        planes_.reserve(planes);
+        boats_.reserve(boats);
+        ants_.reserve(ants);
+    }
+
+    size_t size() const {
+        return planes_.size() + boats_.size() + ants_.size();
+    }
+
+    // Updates each type in one tight loop.
+    // With more than one worker, the concatenation of the three arrays is cut into equal
+    // ranges, so a range may cover the tail of one type and the head of the next.
+    void Update(float dt, FrameWorkers* workers = nullptr) {
+        if (workers == nullptr || workers->size() == 1) {
+            UpdateRange(dt, 0, size());
+            return;
+        }
+        size_t total = size(), parts = workers->size();
+        workers->Run([&](size_t part) {
+            this->UpdateRange(dt, total * part / parts, total * (part + 1) / parts);
+        });
+    }
+
+    // Renders the frame into `frame`, which the caller reuses between frames
+    void Render(std::string& frame) {
+        frame.clear();
+        frame.reserve(planes_.size() * 6 + boats_.size() * 5 + ants_.size() * 4);
+        for (Plane& plane : planes_) {
+            plane.Render(frame);
+        }
+        for (Boat& boat : boats_) {
+            boat.Render(frame);
+        }
+        for (Ant& ant : ants_) {
+            ant.Render(frame);
+        }
+    }
+
+    // Sum of positions, to check that both loops did the same work
+    double Checksum() const {
+        double sum = 0;
+        for (const Plane& plane : planes_) {
+            sum += plane.x();
+        }
+        for (const Boat& boat : boats_) {
+            sum += boat.x();
+        }
+        for (const Ant& ant : ants_) {
+            sum += ant.x();
+        }
+        return sum;
+    }
+
+private:
+    template <typename T>
+    static void UpdateSlice(std::vector<T>& items, float dt, size_t& begin, size_t& end) {
+        size_t n = items.size();
+        for (size_t i = begin; i < std::min(end, n); ++i) {
+            items[i].Update(dt);
+        }
+        begin = begin > n ? begin - n : 0;
+        end = end > n ? end - n : 0;
+    }
+
+    // Updates the objects in [begin, end) of planes, then boats, then ants
+    void UpdateRange(float dt, size_t begin, size_t end) {
+        UpdateSlice(planes_, dt, begin, end);
+        UpdateSlice(boats_, dt, begin, end);
+        UpdateSlice(ants_, dt, begin, end);
+    }
+
+    std::vector<Plane> planes_;
+    std::vector<Boat> boats_;
+    std::vector<Ant> ants_;
+};
+
+// Frame time of the ExtensibleFactory.cpp loop and of EntityStorage for one entity count
+void FrameBenchmark(size_t count, FrameWorkers& workers) {
+    const char* types[] = {"plane", "boat", "ant"};
+    std::mt19937 random(7);
+    std::vector<std::unique_ptr<IGameObject>> owned;
+    std::vector<IGameObject*> gameObjectCollection;
+    EntityStorage storage;
+    storage.Reserve(count / 3 + 1, count / 3 + 1, count / 3 + 1);
+    for (size_t i = 0; i < count; ++i) {
+        std::string_view type = types[random() % 3];
+        float x = static_cast<float>(random() % 100), y = static_cast<float>(random() % 100);
+        if (type == "plane") {
+            owned.push_back(std::make_unique<Plane>(x, y));
+        } else if (type == "boat") {
+            owned.push_back(std::make_unique<Boat>(x, y));
+        } else {
+            owned.push_back(std::make_unique<Ant>(x, y));
+        }
+        gameObjectCollection.push_back(owned.back().get());
+        storage.Spawn(type, x, y);
+    }
+
+    const int frames = count >= 1000000 ? 5 : 20;
+    const float dt = 1.0f / 60;
+    std::ostringstream out;
+    auto begin = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; ++f) {
+        out.str("");
+        for (auto& e: gameObjectCollection) {
+            e->Update(dt);
+            e->Render(out);
+        }
+    }
+    double pointers_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count() / frames;
+
+    std::string frame;
+    begin = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; ++f) {
+        storage.Update(dt, &workers);
+        storage.Render(frame);
+    }
+    double storage_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count() / frames;
+
+    double checksum = 0;
+    for (auto& e: owned) {
+        if (Plane* p = dynamic_cast<Plane*>(e.get())) {
+            checksum += p->x();
+        } else if (Boat* b = dynamic_cast<Boat*>(e.get())) {
+            checksum += b->x();
+        } else {
+            checksum += static_cast<Ant*>(e.get())->x();
+        }
+    }
+    std::cout << "  " << count << " entities: pointer vector " << pointers_ms << " ms/frame, EntityStorage "
+              << storage_ms << " ms/frame (" << workers.size() << " update thread(s)), same result: "
+              << std::boolalpha << (std::abs(checksum - storage.Checksum()) < 1e-3 * count) << "\n";
+}
+
+int main() {
+    EntityStorage storage;
+    for (std::string_view type : {"plane", "plane", "boat", "boat", "ant"}) {
+        storage.Spawn(type, 0, 0);
+    }
+    std::string frame;
+    storage.Update(1.0f / 60);
+    storage.Render(frame);
+    std::cout << frame;
+
+    FrameWorkers workers(std::max(1u, std::thread::hardware_concurrency()));
+    std::cout << "\nFrame time (update + render):\n";
+    for (size_t count : {10000, 100000, 1000000}) {
+        FrameBenchmark(count, workers);
+    }
+    return 0;
+}
@@ -0,0 +1,690 @@
+// A variation of ExtensibleFactory.cpp for level loads that spawn a lot of objects.
+// Once registration is finished the registry can be frozen into a perfect-hash table, so that
+// CreateSingleObject() finds a type with one hash and one string compare, and looks up by
+// std::string_view without allocating. Every registered type also gets its own slab pool, so
+// creating 10^5 objects costs a few hundred slab allocations instead of 10^5 calls to new.
+// LevelLoader reads whole level files through mmap and creates their objects in bulk.
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <map>
+#include <vector>
+#include <fstream>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <thread>
+#include <algorithm>
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Counts heap allocations so the demo can show how many the pools save.
+#include "../../Common/HeapAllocations.h"
+
+class IGameObject {
+public:
+    // Ensure derived classes call the correct destructor
+    virtual ~IGameObject() {}
+
+    virtual void ObjectPlayDefaultAnimation() = 0;
+    virtual void ObjectMoveInGame() = 0;
+    virtual void Update() = 0;
+    virtual void Render() = 0;
+};
+
+class Plane : public IGameObject {
+public:
+    Plane(int x, int y) {
+        ObjectsCreated++;
+    }
+    void ObjectPlayDefaultAnimation() {}
+    void ObjectMoveInGame() {}
+    void Update() {}
+    void Render() {
+        std::cout<<"plane"<<std::endl;
+    }
+    // Constructs the object in storage handed out by the factory's pool
+    static IGameObject* Create(void* storage) {
+        return new (storage) Plane(0, 0);
+    }
+private:
+    static int ObjectsCreated;
+};
+
+int Plane::ObjectsCreated = 0;
+
+class Boat : public IGameObject {
+public:
+    Boat(int x, int y) {
+        ObjectsCreated++;
+    }
+    void ObjectPlayDefaultAnimation() {}
+    void ObjectMoveInGame() {}
+    void Update() {}
+    void Render() {
+        std::cout<<"boat"<<std::endl;
+    }
+    static IGameObject* Create(void* storage) {
+        return new (storage) Boat(0, 0);
+    }
+private:
+    static int ObjectsCreated;
+};
+
+int Boat::ObjectsCreated = 0;
+
+class Ant : public IGameObject {
+public:
+    Ant(int x, int y) {
+        ObjectsCreated++;
+    }
+    void ObjectPlayDefaultAnimation() {}
+    void ObjectMoveInGame() {}
+    void Update() {}
+    void Render() {
+        std::cout<<"ant"<<std::endl;
+    }
+    static IGameObject* Create(void* storage) {
+        return new (storage) Ant(0, 0);
+    }
+private:
+    static int ObjectsCreated;
+};
+
+int Ant::ObjectsCreated = 0;
+
+// A pool of fixed-size blocks carved out of large slabs.
+// Every block starts with a small header that remembers the owning pool, so an object can be
+// given back without knowing its type. Freed blocks are reused before a new slab is taken.
+class ObjectPool {
+public:
+    // Room for the owner pointer, keeping the object itself max_align_t aligned
+    static constexpr size_t kHeaderSize = alignof(std::max_align_t);
+
+    explicit ObjectPool(size_t object_size, size_t objects_per_slab = 256)
+        : block_size_(kHeaderSize + (object_size + kHeaderSize - 1) / kHeaderSize * kHeaderSize),
+          objects_per_slab_(objects_per_slab) {}
+
+    ObjectPool(const ObjectPool&) = delete;
+    void operator=(const ObjectPool&) = delete;
+
+    // Returns uninitialized storage for one object
+    void* Allocate() {
+        std::byte* block;
+        if (free_ != nullptr) {
+            block = reinterpret_cast<std::byte*>(free_);
+            free_ = free_->next;
+            --free_count_;
+        } else {
+            if (next_ == end_) {
+                AddSlab(objects_per_slab_);
+            }
+            block = next_;
+            next_ += block_size_;
+        }
+        *reinterpret_cast<ObjectPool**>(block) = this;
+        ++live_;
+        return block + kHeaderSize;
+    }
+
+    // Gives back storage whose object has already been destroyed
+    void Release(void* object) {
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(static_cast<std::byte*>(object) - kHeaderSize);
+        block->next = free_;
+        free_ = block;
+        ++free_count_;
+        --live_;
+    }
+
+    // Makes sure the next `count` allocations are served without touching the heap,
+    // using one slab of exactly the missing size.
+    void Reserve(size_t count) {
+        size_t available = free_count_ + static_cast<size_t>(end_ - next_) / block_size_;
+        if (available < count) {
+            AddSlab(count - available);
+        }
+    }
+
+    static ObjectPool* OwnerOf(void* object) {
+        return *reinterpret_cast<ObjectPool**>(static_cast<std::byte*>(object) - kHeaderSize);
+    }
+
+    size_t live() const {
+        return live_;
+    }
+    size_t slabs() const {
+        return slabs_.size();
+    }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    // The unused tail of the current slab goes to the free list, then a new slab becomes current
+    void AddSlab(size_t blocks) {
+        for (; next_ != end_; next_ += block_size_) {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(next_);
+            block->next = free_;
+            free_ = block;
+            ++free_count_;
+        }
+        // new[] returns storage aligned for any fundamental type
+        slabs_.emplace_back(new std::byte[blocks * block_size_]);
+        next_ = slabs_.back().get();
+        end_ = next_ + blocks * block_size_;
+    }
+
+    size_t block_size_;
+    size_t objects_per_slab_;
+    std::vector<std::unique_ptr<std::byte[]>> slabs_;
+    std::byte* next_ = nullptr;
+    std::byte* end_ = nullptr;
+    FreeBlock* free_ = nullptr;
+    size_t free_count_ = 0;
+    size_t live_ = 0;
+};
+
+class GameObjectFactory {
+public:
+    // Callback that constructs an object in the storage it is given
+    typedef IGameObject *(*CreateObjectCallback)(void* storage);
+    // Handle to a registered type, for callers that resolve a name once and then
+    // create many objects of it
+    struct Entry;
+    typedef Entry* TypeHandle;
+
+    // Register a new user created object type.
+    // Besides how to 'create' it we need its size, so the factory can set up a pool for it.
+    // Fails once the registry is frozen, or if the type needs more than max_align_t alignment.
+    static bool RegisterObject(std::string_view type, CreateObjectCallback cb, size_t size, size_t alignment);
+    template <typename T>
+    static bool RegisterObject(std::string_view type) {
+        return RegisterObject(type, &T::Create, sizeof(T), alignof(T));
+    }
+    // Unregister a user created object type.
+    // Fails once the registry is frozen, or while objects of that type are still alive.
+    static bool UnregisterObject(std::string_view type);
+    // Builds the perfect-hash table. Registration is closed from now on.
+    static void Freeze();
+    static bool IsFrozen() {
+        return s_Frozen;
+    }
+    // Returns nullptr for an unknown type
+    static TypeHandle Resolve(std::string_view type);
+    // Our Previous 'Factory Method'. Returns nullptr for an unknown type.
+    static IGameObject* CreateSingleObject(std::string_view type);
+    static IGameObject* CreateSingleObject(TypeHandle type) {
+        return type->create_(type->pool_->Allocate());
+    }
+    // Destroys an object made by CreateSingleObject and returns its storage to the pool
+    static void DestroyObject(IGameObject* object);
+    // Pre-sizes the pool of `type` for `count` more objects
+    static bool Reserve(std::string_view type, size_t count);
+    static void Reserve(TypeHandle type, size_t count) {
+        type->pool_->Reserve(count);
+    }
+    struct Entry {
+        CreateObjectCallback create_;
+        std::unique_ptr<ObjectPool> pool_;
+    };
+private:
+    // std::less<> allows find() with a string_view before the registry is frozen
+    typedef std::map<std::string, Entry, std::less<>> CallbackMap;
+    // One slot per hash bucket; the key views the name owned by s_Objects
+    struct Slot {
+        std::string_view key_;
+        Entry* entry_ = nullptr;
+    };
+
+    static uint64_t Hash(std::string_view type, uint64_t seed);
+
+    static CallbackMap s_Objects;
+    static std::vector<Slot> s_Table;
+    static uint64_t s_Seed;
+    static bool s_Frozen;
+};
+
+// initialize our statics
+GameObjectFactory::CallbackMap GameObjectFactory::s_Objects;
+std::vector<GameObjectFactory::Slot> GameObjectFactory::s_Table;
+uint64_t GameObjectFactory::s_Seed = 0;
+bool GameObjectFactory::s_Frozen = false;
+
+bool GameObjectFactory::RegisterObject(std::string_view type, CreateObjectCallback cb, size_t size, size_t alignment) {
+    if (s_Frozen || alignment > ObjectPool::kHeaderSize) {
+        return false;
+    }
+    Entry& entry = s_Objects[std::string(type)];
+    if (entry.pool_ != nullptr && entry.pool_->live() != 0) {
+        return false;
+    }
+    entry.create_ = cb;
+    entry.pool_ = std::make_unique<ObjectPool>(size);
+    return true;
+}
+
+bool GameObjectFactory::UnregisterObject(std::string_view type) {
+    if (s_Frozen) {
+        return false;
+    }
+    CallbackMap::iterator it = s_Objects.find(type);
+    if (it == s_Objects.end() || it->second.pool_->live() != 0) {
+        return false;
+    }
+    s_Objects.erase(it);
+    return true;
+}
+
+// FNV-1a, with the seed folded into the offset basis
+uint64_t GameObjectFactory::Hash(std::string_view type, uint64_t seed) {
+    uint64_t h = 14695981039346656037ull ^ (seed * 0x9E3779B97F4A7C15ull);
+    for (char c : type) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ull;
+    }
+    return h ^ (h >> 32);
+}
+
+// Looks for a seed under which no two names share a bucket, doubling the table if a few
+// dozen seeds don't do it. With a handful of types the first table almost always works.
+void GameObjectFactory::Freeze() {
+    size_t capacity = 1;
+    while (capacity < s_Objects.size()) {
+        capacity *= 2;
+    }
+    for (;; capacity *= 2) {
+        for (uint64_t seed = 0; seed < 64; ++seed) {
+            std::vector<Slot> table(capacity);
+            bool collision = false;
+            for (CallbackMap::iterator it = s_Objects.begin(); it != s_Objects.end() && !collision; ++it) {
+                Slot& slot = table[Hash(it->first, seed) & (capacity - 1)];
+                collision = slot.entry_ != nullptr;
+                slot.key_ = it->first;
+                slot.entry_ = &it->second;
+            }
+            if (!collision) {
+                s_Table = std::move(table);
+                s_Seed = seed;
+                s_Frozen = true;
+                return;
+            }
+        }
+    }
+}
+
+GameObjectFactory::TypeHandle GameObjectFactory::Resolve(std::string_view type) {
+    if (s_Frozen) {
+        const Slot& slot = s_Table[Hash(type, s_Seed) & (s_Table.size() - 1)];
+        return slot.entry_ != nullptr && slot.key_ == type ? slot.entry_ : nullptr;
+    }
+    CallbackMap::iterator it = s_Objects.find(type);
+    return it != s_Objects.end() ? &it->second : nullptr;
+}
+
+IGameObject* GameObjectFactory::CreateSingleObject(std::string_view type) {
+    TypeHandle entry = Resolve(type);
+    return entry != nullptr ? CreateSingleObject(entry) : nullptr;
+}
+
+void GameObjectFactory::DestroyObject(IGameObject* object) {
+    if (object == nullptr) {
+        return;
+    }
+    // The pool header sits in front of the most derived object, not necessarily the base
+    void* storage = dynamic_cast<void*>(object);
+    object->~IGameObject();
+    ObjectPool::OwnerOf(storage)->Release(storage);
+}
+
+bool GameObjectFactory::Reserve(std::string_view type, size_t count) {
+    TypeHandle entry = Resolve(type);
+    if (entry == nullptr) {
+        return false;
+    }
+    Reserve(entry, count);
+    return true;
+}
+
+// A read-only memory mapping of a whole file. The level is parsed straight out of the page
+// cache; nothing is copied into std::string lines.
+class MappedFile {
+public:
+    explicit MappedFile(const char* path) {
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            return;
+        }
+        if (info.st_size > 0) {
+            void* data = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                data_ = static_cast<const char*>(data);
+                size_ = static_cast<size_t>(info.st_size);
+                ::madvise(data, size_, MADV_SEQUENTIAL);
+            }
+        }
+        valid_ = info.st_size == 0 || data_ != nullptr;
+        ::close(fd);
+    }
+    ~MappedFile() {
+        if (data_ != nullptr) {
+            ::munmap(const_cast<char*>(data_), size_);
+        }
+    }
+    MappedFile(const MappedFile&) = delete;
+    void operator=(const MappedFile&) = delete;
+
+    // False if the file couldn't be opened or mapped. An empty file is valid.
+    bool valid() const {
+        return valid_;
+    }
+    std::string_view view() const {
+        return std::string_view(data_, size_);
+    }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool valid_ = false;
+};
+
+// What a level load did and what it cost
+struct LevelStats {
+    size_t lines = 0;
+    size_t objects = 0;
+    size_t unknown = 0;
+    double parse_ms = 0;
+    double create_ms = 0;
+    // Peak resident set of the whole process so far, in KiB
+    long peak_rss_kb = 0;
+};
+
+long PeakRssKb() {
+    struct rusage usage;
+    ::getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// Loads a level file with one type name per line.
+// The file is split into chunks at line boundaries, and each chunk is parsed (optionally on
+// its own thread) into a column of type indices plus a count per type. Each distinct name is
+// resolved against the factory once per chunk. The counts are then used to reserve every pool
+// and the output exactly, and the objects are created in file order. The creation pass stays
+// on the calling thread, because the pools are not thread-safe.
+class LevelLoader {
+public:
+    explicit LevelLoader(size_t threads = 1) : threads_(threads == 0 ? 1 : threads) {}
+
+    // Appends the level's objects to `out` and skips unknown types.
+    // Returns false if the file can't be read.
+    bool Load(const char* path, std::vector<IGameObject*>& out, LevelStats* stats = nullptr) const {
+        auto begin = std::chrono::steady_clock::now();
+        MappedFile file(path);
+        if (!file.valid()) {
+            return false;
+        }
+        std::vector<Chunk> chunks = Split(file.view());
+        if (chunks.size() == 1) {
+            Parse(chunks[0]);
+        } else {
+            std::vector<std::thread> workers;
+            workers.reserve(chunks.size());
+            for (Chunk& chunk : chunks) {
+                workers.emplace_back([&chunk] { Parse(chunk); });
+            }
+            for (std::thread& worker : workers) {
+                worker.join();
+            }
+        }
+        auto parsed = std::chrono::steady_clock::now();
+
+        // Count-per-type pre-pass: merge the chunks' counts and reserve exactly
+        std::vector<std::pair<GameObjectFactory::TypeHandle, size_t>> totals;
+        LevelStats result;
+        for (const Chunk& chunk : chunks) {
+            result.lines += chunk.lines_.size();
+            for (const Chunk::Type& type : chunk.types_) {
+                if (type.handle_ == nullptr) {
+                    result.unknown += type.count_;
+                    continue;
+                }
+                size_t i = 0;
+                while (i < totals.size() && totals[i].first != type.handle_) {
+                    ++i;
+                }
+                if (i == totals.size()) {
+                    totals.emplace_back(type.handle_, 0);
+                }
+                totals[i].second += type.count_;
+            }
+        }
+        for (const std::pair<GameObjectFactory::TypeHandle, size_t>& total : totals) {
+            GameObjectFactory::Reserve(total.first, total.second);
+        }
+        out.reserve(out.size() + result.lines - result.unknown);
+
+        for (const Chunk& chunk : chunks) {
+            for (uint16_t index : chunk.lines_) {
+                if (GameObjectFactory::TypeHandle handle = chunk.types_[index].handle_) {
+                    out.push_back(GameObjectFactory::CreateSingleObject(handle));
+                }
+            }
+        }
+        auto created = std::chrono::steady_clock::now();
+
+        if (stats != nullptr) {
+            result.objects = result.lines - result.unknown;
+            result.parse_ms = std::chrono::duration<double, std::milli>(parsed - begin).count();
+            result.create_ms = std::chrono::duration<double, std::milli>(created - parsed).count();
+            result.peak_rss_kb = PeakRssKb();
+            *stats = result;
+        }
+        return true;
+    }
+
+private:
+    struct Chunk {
+        struct Type {
+            std::string_view name_;
+            GameObjectFactory::TypeHandle handle_;
+            size_t count_;
+        };
+        std::string_view text_;
+        // The distinct names seen in this chunk. Levels use a handful of types, so a linear
+        // scan beats hashing every line. Entry 0 is a catch-all for unknown names.
+        std::vector<Type> types_{Type{std::string_view(), nullptr, 0}};
+        // One entry per line: the index of its name in types_
+        std::vector<uint16_t> lines_;
+    };
+
+    std::vector<Chunk> Split(std::string_view text) const {
+        std::vector<Chunk> chunks;
+        size_t target = text.size() / threads_ + 1;
+        while (!text.empty()) {
+            size_t end = text.size() <= target ? std::string_view::npos : text.find('\n', target);
+            end = end == std::string_view::npos ? text.size() : end + 1;
+            chunks.emplace_back();
+            chunks.back().text_ = text.substr(0, end);
+            text.remove_prefix(end);
+        }
+        if (chunks.empty()) {
+            chunks.emplace_back();
+        }
+        return chunks;
+    }
+
+    static void Parse(Chunk& chunk) {
+        std::string_view text = chunk.text_;
+        chunk.lines_.reserve(text.size() / 4);
+        uint16_t last = 0;
+        while (!text.empty()) {
+            size_t end = text.find('\n');
+            std::string_view line = text.substr(0, end);
+            text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+            if (line.empty()) {
+                continue;
+            }
+            // Consecutive lines often repeat the same type
+            if (chunk.types_[last].name_ != line) {
+                last = 0;
+                while (last < chunk.types_.size() && chunk.types_[last].name_ != line) {
+                    ++last;
+                }
+                if (last == chunk.types_.size()) {
+                    if (last == UINT16_MAX) {
+                        // Out of indices: lump the line in with the other unknown names
+                        last = 0;
+                    } else {
+                        chunk.types_.push_back(Chunk::Type{line, GameObjectFactory::Resolve(line), 0});
+                    }
+                }
+            }
+            ++chunk.types_[last].count_;
+            chunk.lines_.push_back(last);
+        }
+    }
+
+    size_t threads_;
+};
+
+// Spawns `count` objects the way ExtensibleFactory.cpp does: a std::map<std::string, ...>
+// lookup and one new per object.
+void LegacySpawn(const std::vector<std::string>& names, std::vector<IGameObject*>& out) {
+    typedef IGameObject *(*LegacyCallback)();
+    std::map<std::string, LegacyCallback> objects;
+    objects["plane"] = []() -> IGameObject* { return new Plane(0, 0); };
+    objects["boat"] = []() -> IGameObject* { return new Boat(0, 0); };
+    objects["ant"] = []() -> IGameObject* { return new Ant(0, 0); };
+    for (const std::string& name : names) {
+        std::map<std::string, LegacyCallback>::iterator it = objects.find(name);
+        if (it != objects.end()) {
+            out.push_back(it->second());
+        }
+    }
+}
+
+// Loads the same generated level with getline + CreateSingleObject and with LevelLoader
+void LevelBenchmark() {
+    const size_t count = 2000000;
+    std::string path = (std::filesystem::temp_directory_path() / "pooled_factory_level.txt").string();
+    {
+        const char* types[] = {"plane", "boat", "ant", "tree"};
+        std::ofstream level(path);
+        for (size_t i = 0; i < count; ++i) {
+            level << types[(i * 7 + i / 5) % 4] << '\n';
+        }
+    }
+
+    std::vector<IGameObject*> objects;
+    auto begin = std::chrono::steady_clock::now();
+    std::string line;
+    std::ifstream myFile(path);
+    while (std::getline(myFile, line)) {
+        if (IGameObject* object = GameObjectFactory::CreateSingleObject(line)) {
+            objects.push_back(object);
+        }
+    }
+    double getline_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << "\nLoading a level of " << count << " lines:\n"
+              << "  getline:                  " << getline_ms << " ms, " << objects.size() << " objects\n";
+    for (auto& e: objects) {
+        GameObjectFactory::DestroyObject(e);
+    }
+    objects.clear();
+
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t t = 1;; t = threads) {
+        LevelStats stats;
+        LevelLoader(t).Load(path.c_str(), objects, &stats);
+        std::cout << "  LevelLoader, " << t << " thread(s): " << stats.parse_ms + stats.create_ms << " ms (parse "
+                  << stats.parse_ms << ", create " << stats.create_ms << "), " << stats.objects << " objects, "
+                  << stats.unknown << " unknown, peak RSS " << stats.peak_rss_kb / 1024 << " MiB\n";
+        for (auto& e: objects) {
+            GameObjectFactory::DestroyObject(e);
+        }
+        objects.clear();
+        if (t == threads) {
+            break;
+        }
+    }
+    std::filesystem::remove(path);
+}
+
+int main() {
+    // Register a different type
+    GameObjectFactory::RegisterObject<Plane>("plane");
+    GameObjectFactory::RegisterObject<Boat>("boat");
+    GameObjectFactory::RegisterObject<Ant>("ant");
+    // Nothing else gets registered, so the lookups can go through the perfect-hash table
+    GameObjectFactory::Freeze();
+
+    std::vector<IGameObject*> gameObjectCollection;
+    // Add the correct object to our collection based on a .txt file.
+    // Unknown types are skipped instead of being stored as nullptr.
+    LevelLoader().Load("level1.txt", gameObjectCollection);
+
+    for (auto& e: gameObjectCollection) {
+        e->Update();
+        e->Render();
+    }
+    for (auto& e: gameObjectCollection) {
+        GameObjectFactory::DestroyObject(e);
+    }
+
+    // Spawn a big level both ways and compare heap traffic
+    const size_t count = 100000;
+    const char* types[] = {"plane", "boat", "ant"};
+    std::vector<std::string> names;
+    names.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        names.push_back(types[(i * 7) % 3]);
+    }
+
+    std::vector<IGameObject*> legacy, pooled;
+    legacy.reserve(count);
+    pooled.reserve(count);
+
+    size_t allocations = g_HeapAllocations;
+    auto begin = std::chrono::steady_clock::now();
+    LegacySpawn(names, legacy);
+    auto legacy_time = std::chrono::steady_clock::now() - begin;
+    size_t legacy_allocations = g_HeapAllocations - allocations;
+
+    allocations = g_HeapAllocations;
+    begin = std::chrono::steady_clock::now();
+    for (const std::string& name : names) {
+        pooled.push_back(GameObjectFactory::CreateSingleObject(name));
+    }
+    auto pooled_time = std::chrono::steady_clock::now() - begin;
+    size_t pooled_allocations = g_HeapAllocations - allocations;
+
+    std::cout << "\nSpawning " << count << " objects:\n"
+              << "  map + new:            " << std::chrono::duration<double, std::nano>(legacy_time).count() / count
+              << " ns per object, " << legacy_allocations << " heap allocations\n"
+              << "  perfect hash + pools: " << std::chrono::duration<double, std::nano>(pooled_time).count() / count
+              << " ns per object, " << pooled_allocations << " heap allocations\n";
+
+    for (auto& e: legacy) {
+        delete e;
+    }
+    for (auto& e: pooled) {
+        GameObjectFactory::DestroyObject(e);
+    }
+
+    LevelBenchmark();
+    return 0;
+}
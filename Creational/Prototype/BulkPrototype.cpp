@@ -0,0 +1,303 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <array>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstddef>
+#include <new>
+#include <limits>
+
+// Prototype Design Pattern, bulk cloning
+//
+// Spawning thousands of copies one virtual Clone() at a time costs one heap
+// allocation and one name copy per object. CloneN builds all n copies into a
+// single contiguous block owned by the caller. The prototype's name is
+// interned by the factory and shared by every copy, so each of the n copy
+// constructions only copies a few plain members and allocates nothing.
+
+// Counts heap allocations so the demo can show what CloneN saves.
+#include "../../Common/HeapAllocations.h"
+
+enum Type
+{
+    PROTOTYPE_1 = 0,
+    PROTOTYPE_2,
+    PROTOTYPE_COUNT
+};
+
+class Prototype;
+
+/**
+ * n objects of one concrete prototype class, stored back to back in one
+ * allocation. It is indexed through the base class, so the caller doesn't need
+ * to know the concrete class.
+ */
+class PrototypeBlock
+{
+private:
+    std::byte *data_ = nullptr;
+    size_t size_ = 0;
+    size_t stride_ = 0;
+    /**
+     * Turns an element address back into a Prototype*, and destroys elements,
+     * with the concrete class known.
+     */
+    Prototype *(*at_)(std::byte *) = nullptr;
+    void (*destroy_)(std::byte *, size_t) = nullptr;
+
+public:
+    PrototypeBlock() {}
+    PrototypeBlock(PrototypeBlock &&other) noexcept
+    {
+        *this = std::move(other);
+    }
+    PrototypeBlock &operator=(PrototypeBlock &&other) noexcept
+    {
+        if (this != &other)
+        {
+            this->Release();
+            data_ = other.data_;
+            size_ = other.size_;
+            stride_ = other.stride_;
+            at_ = other.at_;
+            destroy_ = other.destroy_;
+            other.data_ = nullptr;
+            other.size_ = 0;
+        }
+        return *this;
+    }
+    PrototypeBlock(const PrototypeBlock &) = delete;
+    PrototypeBlock &operator=(const PrototypeBlock &) = delete;
+    ~PrototypeBlock()
+    {
+        this->Release();
+    }
+
+    /**
+     * Builds `n` copies of `prototype` in one allocation. Returns an empty
+     * block if `n` copies wouldn't fit in the address space.
+     */
+    template <typename T>
+    static PrototypeBlock Fill(const T &prototype, size_t n)
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "operator new only guarantees max_align_t");
+        PrototypeBlock block;
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T))
+        {
+            return block;
+        }
+        block.data_ = static_cast<std::byte *>(::operator new(n * sizeof(T)));
+        block.size_ = n;
+        block.stride_ = sizeof(T);
+        block.at_ = [](std::byte *p) -> Prototype *
+        { return reinterpret_cast<T *>(p); };
+        block.destroy_ = [](std::byte *p, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                reinterpret_cast<T *>(p)[i].T::~T();
+            }
+        };
+        std::uninitialized_fill_n(reinterpret_cast<T *>(block.data_), n, prototype);
+        return block;
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+    Prototype &operator[](size_t i) const
+    {
+        return *at_(data_ + i * stride_);
+    }
+
+private:
+    void Release()
+    {
+        if (data_ != nullptr)
+        {
+            destroy_(data_, size_);
+            ::operator delete(data_);
+            data_ = nullptr;
+        }
+    }
+};
+
+/**
+ * The example class that has cloning ability. The name is a view of a string
+ * interned by the factory, so copies share it instead of duplicating it.
+ */
+
+class Prototype
+{
+protected:
+    std::string_view prototype_name_;
+    float prototype_field_ = 0;
+
+public:
+    Prototype() {}
+    Prototype(std::string_view prototype_name) : prototype_name_(prototype_name) {}
+    virtual ~Prototype() {}
+    virtual Prototype *Clone() const = 0;
+    /**
+     * `n` copies of this object in one contiguous block.
+     */
+    virtual PrototypeBlock CloneN(size_t n) const = 0;
+    virtual void Method(float prototype_field)
+    {
+        this->prototype_field_ = prototype_field;
+        std::cout << "Call Method from " << prototype_name_ << " with field : " << prototype_field << std::endl;
+    }
+    std::string_view name() const
+    {
+        return prototype_name_;
+    }
+};
+
+class ConcretePrototype1 : public Prototype
+{
+private:
+    float concrete_prototype_field1_;
+
+public:
+    ConcretePrototype1(std::string_view prototype_name, float concrete_prototype_field) : Prototype(prototype_name), concrete_prototype_field1_(concrete_prototype_field) {}
+
+    Prototype *Clone() const override
+    {
+        return new ConcretePrototype1(*this);
+    }
+    PrototypeBlock CloneN(size_t n) const override
+    {
+        return PrototypeBlock::Fill(*this, n);
+    }
+};
+
+class ConcretePrototype2 : public Prototype
+{
+private:
+    float concrete_prototype_field2_;
+
+public:
+    ConcretePrototype2(std::string_view prototype_name, float concrete_prototype_field) : Prototype(prototype_name), concrete_prototype_field2_(concrete_prototype_field) {}
+
+    Prototype *Clone() const override
+    {
+        return new ConcretePrototype2(*this);
+    }
+    PrototypeBlock CloneN(size_t n) const override
+    {
+        return PrototypeBlock::Fill(*this, n);
+    }
+};
+
+/**
+ * Stable storage for names; an interned name lives as long as the table.
+ */
+class NameTable
+{
+private:
+    std::deque<std::string> names_;
+
+public:
+    std::string_view Intern(std::string_view name)
+    {
+        for (const std::string &existing : names_)
+        {
+            if (existing == name)
+            {
+                return existing;
+            }
+        }
+        return names_.emplace_back(name);
+    }
+};
+
+/**
+ * In PrototypeFactory you have two concrete prototypes, one for each concrete
+ * prototype class. The factory owns the names, so clones must not outlive it.
+ */
+
+class PrototypeFactory
+{
+private:
+    NameTable names_;
+    std::array<std::unique_ptr<Prototype>, PROTOTYPE_COUNT> prototypes_;
+
+public:
+    PrototypeFactory()
+    {
+        prototypes_[Type::PROTOTYPE_1] = std::make_unique<ConcretePrototype1>(names_.Intern("PROTOTYPE_1 "), 50.f);
+        prototypes_[Type::PROTOTYPE_2] = std::make_unique<ConcretePrototype2>(names_.Intern("PROTOTYPE_2 "), 60.f);
+    }
+
+    Prototype *CreatePrototype(Type type)
+    {
+        return prototypes_[type]->Clone();
+    }
+
+    /**
+     * Spawns `n` copies of the prototype of `type` with a single allocation.
+     */
+    PrototypeBlock CloneN(Type type, size_t n)
+    {
+        return prototypes_[type]->CloneN(n);
+    }
+};
+
+void Client(PrototypeFactory &prototype_factory)
+{
+    std::cout << "Let's create a Prototype 1\n";
+
+    Prototype *prototype = prototype_factory.CreatePrototype(Type::PROTOTYPE_1);
+    prototype->Method(90);
+    delete prototype;
+
+    std::cout << "\n";
+
+    std::cout << "Let's create three Prototype 2 at once\n";
+    PrototypeBlock block = prototype_factory.CloneN(Type::PROTOTYPE_2, 3);
+    for (size_t i = 0; i < block.size(); ++i)
+    {
+        block[i].Method(10.f * static_cast<float>(i));
+    }
+}
+
+int main()
+{
+    PrototypeFactory prototype_factory;
+    Client(prototype_factory);
+
+    const size_t n = 100000;
+    std::vector<Prototype *> clones;
+    clones.reserve(n);
+
+    size_t allocations = g_HeapAllocations;
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i)
+    {
+        clones.push_back(prototype_factory.CreatePrototype(Type::PROTOTYPE_1));
+    }
+    auto clone_time = std::chrono::steady_clock::now() - begin;
+    size_t clone_allocations = g_HeapAllocations - allocations;
+
+    allocations = g_HeapAllocations;
+    begin = std::chrono::steady_clock::now();
+    PrototypeBlock block = prototype_factory.CloneN(Type::PROTOTYPE_1, n);
+    auto block_time = std::chrono::steady_clock::now() - begin;
+    size_t block_allocations = g_HeapAllocations - allocations;
+
+    std::cout << "\nSpawning " << n << " copies of " << block[n - 1].name() << ":\n"
+              << "  Clone() one by one: " << std::chrono::duration<double, std::micro>(clone_time).count() << " us, "
+              << clone_allocations << " allocations\n"
+              << "  CloneN:             " << std::chrono::duration<double, std::micro>(block_time).count() << " us, "
+              << block_allocations << " allocation(s)\n";
+
+    for (Prototype *p : clones)
+    {
+        delete p;
+    }
+    return 0;
+}
@@ -0,0 +1,363 @@
+#include <iostream>
+#include <string>
+#include <array>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstddef>
+
+// Prototype Design Pattern, pooled
+//
+// Bullets are cloned at very high rates and thrown away right after. Here
+// CreatePrototype hands out an object recycled from a per-type free list,
+// copy-assigned from the prototype, inside an RAII handle that gives it back
+// to the pool when it goes out of scope. Only when the free list is empty is a
+// new object cloned.
+
+enum Type
+{
+    PROTOTYPE_1 = 0,
+    PROTOTYPE_2,
+    PROTOTYPE_COUNT
+};
+
+/**
+ * The example class that has cloning ability. Besides Clone() it can be
+ * copy-assigned from another object of the same concrete class, which is how a
+ * recycled object is reset to the prototype's state.
+ */
+
+class Prototype
+{
+protected:
+    std::string prototype_name_;
+    float prototype_field_;
+
+public:
+    Prototype() {}
+    Prototype(std::string prototype_name) : prototype_name_(prototype_name) {}
+    virtual ~Prototype() {}
+    virtual Prototype *Clone() const = 0;
+    /**
+     * Copies `other`, which must have the same concrete class, into this. The
+     * string is assigned into existing capacity, so this doesn't allocate.
+     */
+    virtual void AssignFrom(const Prototype &other) = 0;
+    virtual void Method(float prototype_field)
+    {
+        this->prototype_field_ = prototype_field;
+        std::cout << "Call Method from " << prototype_name_ << " with field : " << prototype_field << std::endl;
+    }
+    /**
+     * The same as Method without the output, for the benchmark.
+     */
+    void SetField(float prototype_field)
+    {
+        this->prototype_field_ = prototype_field;
+    }
+};
+
+class ConcretePrototype1 : public Prototype
+{
+private:
+    float concrete_prototype_field1_;
+
+public:
+    ConcretePrototype1(std::string prototype_name, float concrete_prototype_field) : Prototype(prototype_name), concrete_prototype_field1_(concrete_prototype_field) {}
+
+    Prototype *Clone() const override
+    {
+        return new ConcretePrototype1(*this);
+    }
+    void AssignFrom(const Prototype &other) override
+    {
+        *this = static_cast<const ConcretePrototype1 &>(other);
+    }
+};
+
+class ConcretePrototype2 : public Prototype
+{
+private:
+    float concrete_prototype_field2_;
+
+public:
+    ConcretePrototype2(std::string prototype_name, float concrete_prototype_field) : Prototype(prototype_name), concrete_prototype_field2_(concrete_prototype_field) {}
+
+    Prototype *Clone() const override
+    {
+        return new ConcretePrototype2(*this);
+    }
+    void AssignFrom(const Prototype &other) override
+    {
+        *this = static_cast<const ConcretePrototype2 &>(other);
+    }
+};
+
+struct PoolStats
+{
+    /**
+     * Requests served from the free list.
+     */
+    size_t hits_ = 0;
+    /**
+     * Requests that had to Clone() a new object.
+     */
+    size_t misses_ = 0;
+    /**
+     * Objects currently handed out.
+     */
+    size_t in_use_ = 0;
+    /**
+     * Objects waiting on the free list.
+     */
+    size_t pooled_ = 0;
+};
+
+/**
+ * The free list of one prototype type. It keeps at most `capacity` idle
+ * objects; anything returned beyond that is deleted.
+ */
+class ClonePool
+{
+private:
+    std::vector<Prototype *> free_;
+    size_t capacity_;
+    PoolStats stats_;
+
+public:
+    explicit ClonePool(size_t capacity = 1024) : capacity_(capacity)
+    {
+        free_.reserve(capacity);
+    }
+    ClonePool(const ClonePool &) = delete;
+    ClonePool &operator=(const ClonePool &) = delete;
+    ~ClonePool()
+    {
+        for (Prototype *p : free_)
+        {
+            delete p;
+        }
+    }
+
+    Prototype *Acquire(const Prototype &prototype)
+    {
+        Prototype *p;
+        if (!free_.empty())
+        {
+            p = free_.back();
+            free_.pop_back();
+            p->AssignFrom(prototype);
+            ++stats_.hits_;
+        }
+        else
+        {
+            p = prototype.Clone();
+            ++stats_.misses_;
+        }
+        ++stats_.in_use_;
+        return p;
+    }
+
+    void Release(Prototype *p)
+    {
+        --stats_.in_use_;
+        if (free_.size() < capacity_)
+        {
+            free_.push_back(p);
+        }
+        else
+        {
+            delete p;
+        }
+    }
+
+    PoolStats Stats() const
+    {
+        PoolStats stats = stats_;
+        stats.pooled_ = free_.size();
+        return stats;
+    }
+};
+
+/**
+ * Owns one pooled clone and returns it to its pool on destruction. Handles
+ * must not outlive the PrototypeFactory they came from.
+ */
+class PooledPrototype
+{
+private:
+    Prototype *object_ = nullptr;
+    ClonePool *pool_ = nullptr;
+
+public:
+    PooledPrototype() {}
+    PooledPrototype(Prototype *object, ClonePool *pool) : object_(object), pool_(pool) {}
+    PooledPrototype(PooledPrototype &&other) noexcept : object_(other.object_), pool_(other.pool_)
+    {
+        other.object_ = nullptr;
+    }
+    PooledPrototype &operator=(PooledPrototype &&other) noexcept
+    {
+        if (this != &other)
+        {
+            this->reset();
+            object_ = other.object_;
+            pool_ = other.pool_;
+            other.object_ = nullptr;
+        }
+        return *this;
+    }
+    PooledPrototype(const PooledPrototype &) = delete;
+    PooledPrototype &operator=(const PooledPrototype &) = delete;
+    ~PooledPrototype()
+    {
+        this->reset();
+    }
+
+    /**
+     * Returns the object to its pool early.
+     */
+    void reset()
+    {
+        if (object_ != nullptr)
+        {
+            pool_->Release(object_);
+            object_ = nullptr;
+        }
+    }
+
+    Prototype *get() const
+    {
+        return object_;
+    }
+    Prototype *operator->() const
+    {
+        return object_;
+    }
+    Prototype &operator*() const
+    {
+        return *object_;
+    }
+};
+
+/**
+ * In PrototypeFactory you have two concrete prototypes, one for each concrete
+ * prototype class. Type is a dense enum, so prototypes and pools live in plain
+ * arrays indexed by it.
+ */
+
+class PrototypeFactory
+{
+private:
+    std::array<std::unique_ptr<Prototype>, PROTOTYPE_COUNT> prototypes_;
+    std::array<ClonePool, PROTOTYPE_COUNT> pools_;
+
+public:
+    PrototypeFactory()
+    {
+        prototypes_[Type::PROTOTYPE_1] = std::make_unique<ConcretePrototype1>("PROTOTYPE_1 ", 50.f);
+        prototypes_[Type::PROTOTYPE_2] = std::make_unique<ConcretePrototype2>("PROTOTYPE_2 ", 60.f);
+    }
+
+    /**
+     * Notice here that you just need to specify the type of the prototype you
+     * want and the method will hand out a recycled copy of that prototype.
+     */
+    PooledPrototype CreatePrototype(Type type)
+    {
+        return PooledPrototype(pools_[type].Acquire(*prototypes_[type]), &pools_[type]);
+    }
+
+    /**
+     * The unpooled path: a fresh clone the caller has to delete.
+     */
+    Prototype *ClonePrototype(Type type) const
+    {
+        return prototypes_[type]->Clone();
+    }
+
+    PoolStats Stats(Type type) const
+    {
+        return pools_[type].Stats();
+    }
+};
+
+void Client(PrototypeFactory &prototype_factory)
+{
+    std::cout << "Let's create a Prototype 1\n";
+
+    PooledPrototype prototype = prototype_factory.CreatePrototype(Type::PROTOTYPE_1);
+    prototype->Method(90);
+    prototype.reset();
+
+    std::cout << "\n";
+
+    std::cout << "Let's create a Prototype 2\n";
+    prototype = prototype_factory.CreatePrototype(Type::PROTOTYPE_2);
+    prototype->Method(10);
+    prototype.reset();
+
+    std::cout << "\n";
+
+    std::cout << "And a Prototype 1 again, this time from the pool\n";
+    prototype = prototype_factory.CreatePrototype(Type::PROTOTYPE_1);
+    prototype->Method(30);
+}
+
+template <typename F>
+double NanosecondsPerIteration(size_t iterations, F f)
+{
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        f(i);
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin);
+    return elapsed.count() / static_cast<double>(iterations);
+}
+
+void PrintStats(const char *name, const PoolStats &stats)
+{
+    std::cout << "  " << name << ": " << stats.hits_ << " hits, " << stats.misses_ << " misses, "
+              << stats.in_use_ << " in use, " << stats.pooled_ << " pooled\n";
+}
+
+int main()
+{
+    PrototypeFactory prototype_factory;
+    Client(prototype_factory);
+
+    // Every frame fires a burst of bullets that all expire by the end of it
+    const size_t frames = 10000, burst = 100;
+    std::vector<Prototype *> raw;
+    std::vector<PooledPrototype> pooled;
+    raw.reserve(burst);
+    pooled.reserve(burst);
+    double raw_ns = NanosecondsPerIteration(frames, [&](size_t)
+                                            {
+        for (size_t i = 0; i < burst; ++i)
+        {
+            raw.push_back(prototype_factory.ClonePrototype(i % 2 ? Type::PROTOTYPE_2 : Type::PROTOTYPE_1));
+            raw.back()->SetField(static_cast<float>(i));
+        }
+        for (Prototype *p : raw)
+        {
+            delete p;
+        }
+        raw.clear(); });
+    double pooled_ns = NanosecondsPerIteration(frames, [&](size_t)
+                                               {
+        for (size_t i = 0; i < burst; ++i)
+        {
+            pooled.push_back(prototype_factory.CreatePrototype(i % 2 ? Type::PROTOTYPE_2 : Type::PROTOTYPE_1));
+            pooled.back()->SetField(static_cast<float>(i));
+        }
+        pooled.clear(); });
+
+    std::cout << "\nFiring " << frames << " bursts of " << burst << " bullets, ns per bullet:\n"
+              << "  Clone() + delete: " << raw_ns / burst << "\n"
+              << "  pooled:           " << pooled_ns / burst << "\n";
+    PrintStats("PROTOTYPE_1", prototype_factory.Stats(Type::PROTOTYPE_1));
+    PrintStats("PROTOTYPE_2", prototype_factory.Stats(Type::PROTOTYPE_2));
+    return 0;
+}
@@ -0,0 +1,310 @@
+// Asynchronous Logger singleton.
+// Every thread that logs gets its own lock-free single-producer ring of fixed-size
+// records, so addMessage never allocates and never takes a lock. A background
+// drain thread collects the records from all rings and writes them out in large
+// batches with a single write() call per batch.
+#include <iostream>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <cstdint>
+#include <unistd.h>
+
+class Logger {
+public:
+    // What addMessage does when the calling thread's ring is full.
+    enum class Policy {
+        Drop,      // discard the new message and count it
+        Block,     // wait until the drain thread frees a slot
+        Overwrite  // discard the oldest unread message and count it
+    };
+
+    struct Stats {
+        uint64_t written;
+        uint64_t dropped;
+        uint64_t overwritten;
+        uint64_t batches;
+        uint64_t maxLatencyNs;  // enqueue -> write(), worst record
+        uint64_t avgLatencyNs;  // enqueue -> write(), mean over all records
+    };
+
+    // A record is preformatted by the producer: the text is copied straight into
+    // the ring slot and truncated if it doesn't fit.
+    static constexpr size_t kRecordSize = 128;
+    static constexpr size_t kRingCapacity = 1024;  // records per thread, power of two
+    static constexpr size_t kBatchBytes = 64 * 1024;
+
+    static Logger& GetInstance() {
+        // Static variables are only initialized once, and their values persist across multiple function calls. In this case, s_instance is initialized the first time GetInstance() is called and retains its value for subsequent calls.
+        static Logger* s_instance = new Logger;
+        return *s_instance;
+    }
+
+    void setPolicy(Policy policy) {
+        m_policy.store(policy, std::memory_order_relaxed);
+    }
+
+    // Hot path: one relaxed load of the thread's ring, a copy into the slot
+    // and one release store. Returns false if the message was dropped.
+    bool addMessage(std::string_view s) {
+        Ring& ring = localRing();
+        uint64_t head = ring.head.load(std::memory_order_relaxed);
+        Policy policy = m_policy.load(std::memory_order_relaxed);
+        while (head - ring.tail.load(std::memory_order_acquire) >= kRingCapacity) {
+            if (policy == Policy::Drop) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (policy == Policy::Overwrite) {
+                uint64_t tail = head - kRingCapacity;
+                if (ring.tail.compare_exchange_strong(tail, tail + 1, std::memory_order_acq_rel)) {
+                    m_overwritten.fetch_add(1, std::memory_order_relaxed);
+                }
+                continue;
+            }
+            std::this_thread::yield();
+        }
+        Record& record = ring.slots[head & (kRingCapacity - 1)];
+        uint32_t length = static_cast<uint32_t>(std::min(s.size(), kTextBytes));
+        uint64_t words[kTextWords] = {};
+        std::memcpy(words, s.data(), length);
+        record.timestamp.store(now(), std::memory_order_relaxed);
+        record.length.store(length, std::memory_order_relaxed);
+        for (size_t i = 0; i < (length + sizeof(uint64_t) - 1) / sizeof(uint64_t); ++i) {
+            record.text[i].store(words[i], std::memory_order_relaxed);
+        }
+        ring.head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Blocks until every message added before the call has been written.
+    void flush() {
+        std::vector<std::pair<Ring*, uint64_t>> pending;
+        {
+            std::lock_guard<std::mutex> lock(m_ringsMutex);
+            for (auto& ring : m_rings) {
+                pending.emplace_back(ring.get(), ring->head.load(std::memory_order_acquire));
+            }
+        }
+        m_flushRequested.store(true, std::memory_order_release);
+        for (auto& [ring, head] : pending) {
+            while (ring->tail.load(std::memory_order_acquire) < head) {
+                std::this_thread::yield();
+            }
+        }
+        // The pass that consumed the last records bumps the counter only after
+        // its write() has returned.
+        uint64_t pass = m_drainPasses.load(std::memory_order_acquire);
+        while (m_drainPasses.load(std::memory_order_acquire) <= pass) {
+            std::this_thread::yield();
+        }
+    }
+
+    void printMessages() {
+        flush();
+    }
+
+    Stats stats() const {
+        uint64_t written = m_written.load(std::memory_order_relaxed);
+        return {written,
+                m_dropped.load(std::memory_order_relaxed),
+                m_overwritten.load(std::memory_order_relaxed),
+                m_batches.load(std::memory_order_relaxed),
+                m_maxLatency.load(std::memory_order_relaxed),
+                written ? m_totalLatency.load(std::memory_order_relaxed) / written : 0};
+    }
+
+private:
+    static constexpr size_t kTextWords = (kRecordSize - 2 * sizeof(uint64_t)) / sizeof(uint64_t);
+    static constexpr size_t kTextBytes = kTextWords * sizeof(uint64_t);
+
+    // Under Policy::Overwrite the producer may rewrite a slot while the drain
+    // thread is still copying it, so every field is a relaxed atomic and the
+    // text is copied a word at a time. A torn copy is never kept: the producer
+    // only reuses the slot after moving the tail past it, which makes the
+    // drain thread's claim of that tail fail.
+    struct Record {
+        std::atomic<uint64_t> timestamp;
+        std::atomic<uint32_t> length;
+        std::atomic<uint64_t> text[kTextWords];
+    };
+    static_assert(sizeof(Record) == kRecordSize, "a record fills its slot exactly");
+
+    // Single producer (the owning thread), single consumer (the drain thread).
+    // head and tail live on separate cache lines so they don't bounce between
+    // the two.
+    struct Ring {
+        alignas(64) std::atomic<uint64_t> head{0};
+        alignas(64) std::atomic<uint64_t> tail{0};
+        Record slots[kRingCapacity];
+    };
+
+    Logger() : m_drain([this] { drainLoop(); }) {
+    }
+
+    ~Logger() {
+        m_running.store(false, std::memory_order_release);
+        m_drain.join();
+    }
+
+    static uint64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    // Rings are created on a thread's first message and owned by the logger, so
+    // messages from a thread that has already exited are still drained.
+    Ring& localRing() {
+        thread_local Ring* t_ring = nullptr;
+        if (t_ring == nullptr) {
+            std::lock_guard<std::mutex> lock(m_ringsMutex);
+            m_rings.push_back(std::make_unique<Ring>());
+            t_ring = m_rings.back().get();
+            m_ringCount.store(m_rings.size(), std::memory_order_release);
+        }
+        return *t_ring;
+    }
+
+    // Copies every readable record of one ring into the batch buffer. A record
+    // only counts once the tail is advanced past it; if an overwriting producer
+    // got there first, the copy may be torn and is thrown away, and the tail it
+    // moved may be past the head loaded here, so the head is reloaded before
+    // any slot beyond it is read.
+    void drainRing(Ring& ring, std::vector<char>& batch, uint64_t writeTime, uint64_t& latency, uint64_t& maxLatency, uint64_t& count) {
+        uint64_t head = ring.head.load(std::memory_order_acquire);
+        uint64_t tail = ring.tail.load(std::memory_order_acquire);
+        while (tail < head && batch.size() + kRecordSize + 1 <= kBatchBytes) {
+            const Record& record = ring.slots[tail & (kRingCapacity - 1)];
+            size_t start = batch.size();
+            uint64_t timestamp = record.timestamp.load(std::memory_order_relaxed);
+            size_t length = std::min<size_t>(record.length.load(std::memory_order_relaxed), kTextBytes);
+            uint64_t words[kTextWords];
+            for (size_t i = 0; i < (length + sizeof(uint64_t) - 1) / sizeof(uint64_t); ++i) {
+                words[i] = record.text[i].load(std::memory_order_relaxed);
+            }
+            const char* text = reinterpret_cast<const char*>(words);
+            batch.insert(batch.end(), text, text + length);
+            batch.push_back('\n');
+            if (!ring.tail.compare_exchange_strong(tail, tail + 1, std::memory_order_acq_rel)) {
+                batch.resize(start);
+                head = ring.head.load(std::memory_order_acquire);
+                continue;
+            }
+            ++tail;
+            uint64_t age = writeTime > timestamp ? writeTime - timestamp : 0;
+            latency += age;
+            maxLatency = std::max(maxLatency, age);
+            ++count;
+        }
+    }
+
+    void drainLoop() {
+        std::vector<char> batch;
+        batch.reserve(kBatchBytes);
+        std::vector<Ring*> rings;
+        for (;;) {
+            bool stopping = !m_running.load(std::memory_order_acquire);
+            if (rings.size() != m_ringCount.load(std::memory_order_acquire)) {
+                std::lock_guard<std::mutex> lock(m_ringsMutex);
+                rings.clear();
+                for (auto& ring : m_rings) {
+                    rings.push_back(ring.get());
+                }
+            }
+
+            uint64_t writeTime = now();
+            uint64_t latency = 0, maxLatency = 0, count = 0;
+            for (Ring* ring : rings) {
+                drainRing(*ring, batch, writeTime, latency, maxLatency, count);
+            }
+            if (!batch.empty()) {
+                size_t offset = 0;
+                while (offset < batch.size()) {
+                    ssize_t n = ::write(STDOUT_FILENO, batch.data() + offset, batch.size() - offset);
+                    if (n <= 0) {
+                        break;
+                    }
+                    offset += static_cast<size_t>(n);
+                }
+                batch.clear();
+                uint64_t done = now();
+                latency += (done - writeTime) * count;
+                maxLatency += done - writeTime;
+                m_written.fetch_add(count, std::memory_order_relaxed);
+                m_totalLatency.fetch_add(latency, std::memory_order_relaxed);
+                m_batches.fetch_add(1, std::memory_order_relaxed);
+                if (maxLatency > m_maxLatency.load(std::memory_order_relaxed)) {
+                    m_maxLatency.store(maxLatency, std::memory_order_relaxed);
+                }
+            }
+            m_drainPasses.fetch_add(1, std::memory_order_release);
+
+            if (count == 0) {
+                if (stopping) {
+                    return;
+                }
+                if (!m_flushRequested.exchange(false, std::memory_order_acq_rel)) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                }
+            }
+        }
+    }
+
+    std::atomic<Policy> m_policy{Policy::Drop};
+    std::atomic<bool> m_running{true};
+    std::atomic<bool> m_flushRequested{false};
+
+    std::mutex m_ringsMutex;
+    std::vector<std::unique_ptr<Ring>> m_rings;
+    std::atomic<size_t> m_ringCount{0};
+
+    std::atomic<uint64_t> m_written{0};
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<uint64_t> m_overwritten{0};
+    std::atomic<uint64_t> m_batches{0};
+    std::atomic<uint64_t> m_totalLatency{0};
+    std::atomic<uint64_t> m_maxLatency{0};
+    std::atomic<uint64_t> m_drainPasses{0};
+
+    // Declared last so every other member is initialized before it starts.
+    std::thread m_drain;
+};
+
+int main() {
+    Logger::GetInstance().addMessage("Hello");
+    Logger::GetInstance().addMessage("World");
+    Logger::GetInstance().printMessages();
+
+    Logger& logger = Logger::GetInstance();
+    for (Logger::Policy policy : {Logger::Policy::Drop, Logger::Policy::Block, Logger::Policy::Overwrite}) {
+        logger.setPolicy(policy);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 4; ++t) {
+            workers.emplace_back([&logger, t] {
+                char line[64];
+                for (int i = 0; i < 2000; ++i) {
+                    int n = std::snprintf(line, sizeof(line), "worker %d message %d", t, i);
+                    logger.addMessage(std::string_view(line, n));
+                }
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        logger.flush();
+    }
+
+    Logger::Stats stats = logger.stats();
+    std::cout << "written " << stats.written << ", dropped " << stats.dropped << ", overwritten " << stats.overwritten
+              << ", batches " << stats.batches << ", drain latency avg " << stats.avgLatencyNs << " ns, max "
+              << stats.maxLatencyNs << " ns\n";
+    return 0;
+}
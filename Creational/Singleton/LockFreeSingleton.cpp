@@ -0,0 +1,249 @@
+/**
+ * Одинак з неблокуючим швидким шляхом
+ * Багатопотоковий Одинак бере м'ютекс при кожному виклику GetInstance, навіть коли об'єкт уже створено.
+ * Тут м'ютекс потрібен лише під час першого створення, а після нього читач виконує одне атомарне завантаження (acquire).
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+class Singleton
+{
+    /**
+     * The Singleton's constructor should always be private to prevent direct
+     * construction calls with the `new` operator.
+     */
+private:
+    static std::atomic<Singleton *> pinstance_;
+    static std::mutex mutex_;
+
+protected:
+    Singleton(const std::string value) : value_(value) {}
+    ~Singleton() {}
+    std::string value_;
+
+public:
+    /**
+     * Singletons should not be cloneable.
+     */
+    Singleton(Singleton &other) = delete;
+    /**
+     * Singletons should not be assignable.
+     */
+    void operator=(const Singleton &) = delete;
+    /**
+     * Double-checked locking on an atomic pointer. The acquire load pairs with
+     * the release store below, so a thread that sees a non-null pointer also
+     * sees the fully constructed object.
+     */
+    static Singleton *GetInstance(const std::string &value);
+    /**
+     * Finally, any singleton should define some business logic, which can be
+     * executed on its instance.
+     */
+    void SomeBusinessLogic()
+    {
+        // ...
+    }
+
+    std::string value() const
+    {
+        return value_;
+    }
+};
+
+std::atomic<Singleton *> Singleton::pinstance_{nullptr};
+std::mutex Singleton::mutex_;
+
+/**
+ * Static methods should be defined outside the class.
+ */
+/**
+ * Once the instance exists the mutex is never touched again: the first
+ * acquire load returns it. Only the threads racing for the very first
+ * construction take the lock, and the second check under the lock makes sure
+ * just one of them creates the object.
+ */
+Singleton *Singleton::GetInstance(const std::string &value)
+{
+    Singleton *instance = pinstance_.load(std::memory_order_acquire);
+    if (instance == nullptr)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        instance = pinstance_.load(std::memory_order_relaxed);
+        if (instance == nullptr)
+        {
+            instance = new Singleton(value);
+            pinstance_.store(instance, std::memory_order_release);
+        }
+    }
+    return instance;
+}
+
+/**
+ * The same guarantee written as a function-local static (a "Meyers singleton").
+ * The compiler emits an equivalent guard: one acquire load of a flag on the
+ * fast path, and a lock only during initialization.
+ */
+class StaticSingleton
+{
+private:
+    StaticSingleton(const std::string value) : value_(value) {}
+    std::string value_;
+
+public:
+    StaticSingleton(StaticSingleton &other) = delete;
+    void operator=(const StaticSingleton &) = delete;
+
+    static StaticSingleton *GetInstance(const std::string &value)
+    {
+        static StaticSingleton instance(value);
+        return &instance;
+    }
+
+    std::string value() const
+    {
+        return value_;
+    }
+};
+
+/**
+ * The two older variants, kept here only so the benchmark can compare them.
+ */
+class MutexSingleton
+{
+private:
+    static MutexSingleton *pinstance_;
+    static std::mutex mutex_;
+    MutexSingleton() {}
+
+public:
+    static MutexSingleton *GetInstance()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pinstance_ == nullptr)
+        {
+            pinstance_ = new MutexSingleton();
+        }
+        return pinstance_;
+    }
+};
+
+MutexSingleton *MutexSingleton::pinstance_ = nullptr;
+std::mutex MutexSingleton::mutex_;
+
+class NaiveSingleton
+{
+private:
+    static NaiveSingleton *singleton_;
+    NaiveSingleton() {}
+
+public:
+    static NaiveSingleton *GetInstance()
+    {
+        if (singleton_ == nullptr)
+        {
+            singleton_ = new NaiveSingleton();
+        }
+        return singleton_;
+    }
+};
+
+NaiveSingleton *NaiveSingleton::singleton_ = nullptr;
+
+void ThreadFoo()
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+    Singleton *singleton = Singleton::GetInstance("FOO");
+    std::cout << singleton->value() << "\n";
+}
+
+void ThreadBar()
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+    Singleton *singleton = Singleton::GetInstance("BAR");
+    std::cout << singleton->value() << "\n";
+}
+
+/**
+ * Runs `threads` threads that each call `get_instance` `iterations` times and
+ * returns the average cost of one call in nanoseconds. Each thread folds the
+ * returned pointers into a volatile sink so the calls can't be optimized out.
+ */
+template <typename GetInstance>
+double BenchmarkGetInstance(GetInstance get_instance, int threads, long iterations)
+{
+    std::atomic<bool> start{false};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&]()
+                             {
+            while (!start.load(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+            uintptr_t acc = 0;
+            for (long i = 0; i < iterations; ++i)
+            {
+                acc ^= reinterpret_cast<uintptr_t>(get_instance());
+            }
+            volatile uintptr_t sink = acc;
+            (void)sink; });
+    }
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin);
+    return elapsed.count() / (static_cast<double>(iterations) * threads);
+}
+
+int main()
+{
+    std::cout << "If you see the same value, then singleton was reused (yay!\n"
+              << "If you see different values, then 2 singletons were created (booo!!)\n\n"
+              << "RESULT:\n";
+    std::thread t1(ThreadFoo);
+    std::thread t2(ThreadBar);
+    t1.join();
+    t2.join();
+
+    // The naive singleton is only safe to read concurrently once it exists.
+    NaiveSingleton::GetInstance();
+
+    const std::string foo = "FOO";
+    auto mutex_get = []()
+    { return MutexSingleton::GetInstance(); };
+    auto atomic_get = [&foo]()
+    { return Singleton::GetInstance(foo); };
+    auto static_get = [&foo]()
+    { return StaticSingleton::GetInstance(foo); };
+    auto naive_get = []()
+    { return NaiveSingleton::GetInstance(); };
+
+    const long iterations = 2000000;
+    std::cout << "\nGetInstance cost per call (ns), " << std::thread::hardware_concurrency() << " hardware threads:\n"
+              << std::setw(8) << "threads" << std::setw(12) << "mutex" << std::setw(12) << "atomic" << std::setw(12) << "static" << std::setw(12) << "naive" << "\n"
+              << std::fixed << std::setprecision(2);
+    for (int threads = 1; threads <= 64; threads *= 2)
+    {
+        long per_thread = iterations / threads;
+        std::cout << std::setw(8) << threads
+                  << std::setw(12) << BenchmarkGetInstance(mutex_get, threads, per_thread)
+                  << std::setw(12) << BenchmarkGetInstance(atomic_get, threads, per_thread)
+                  << std::setw(12) << BenchmarkGetInstance(static_get, threads, per_thread)
+                  << std::setw(12) << BenchmarkGetInstance(naive_get, threads, per_thread)
+                  << "\n";
+    }
+    return 0;
+}
@@ -25,6 +25,10 @@ public:
         m_messages.push_back(s);
     }
 
+    void clearMessages() {
+        m_messages.clear();
+    }
+
 private:
     Logger() {
         std::cout << "Logger was created\n";
@@ -0,0 +1,544 @@
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+/**
+ * Cached, parallel Composite.
+ *
+ * Every node caches a small aggregate of its subtree (a template parameter:
+ * a label hash, the total label length, ...) together with a dirty flag; the
+ * textual Operation() is only built on demand. Changing a leaf or adding/removing a child marks the node and its
+ * ancestors dirty by walking GetParent(), stopping at the first ancestor that
+ * is already dirty. Evaluation only recomputes dirty nodes, so after a single
+ * change it re-evaluates depth + 1 nodes instead of the whole tree; each of
+ * them folds all of its children, so that is O(depth x fanout) Combine calls
+ * rather than O(nodes). Large dirty
+ * subtrees can be evaluated in parallel: each child of a big enough composite
+ * becomes a task on a work-stealing pool.
+ */
+
+/**
+ * A small work-stealing pool. Each worker owns a deque: it pushes and pops at
+ * the back, idle workers steal from the front of the others. A thread waiting
+ * on its own tasks keeps running tasks instead of blocking, so nested
+ * parallelism can't deadlock the pool.
+ */
+class WorkStealingPool
+{
+public:
+    using Task = std::function<void()>;
+
+    explicit WorkStealingPool(size_t threads) : queues_(threads + 1)
+    {
+        for (size_t i = 0; i < threads; ++i)
+        {
+            workers_.emplace_back([this, i]
+                                  { this->WorkerLoop(i + 1); });
+        }
+    }
+
+    ~WorkStealingPool()
+    {
+        stopping_.store(true);
+        {
+            std::lock_guard<std::mutex> lock(idle_mutex_);
+        }
+        idle_.notify_all();
+        for (std::thread &worker : workers_)
+        {
+            worker.join();
+        }
+    }
+
+    /**
+     * Queues a task on the calling worker's own deque. Threads that are not
+     * pool workers use the extra queue 0.
+     */
+    void Submit(Task task)
+    {
+        Queue &queue = queues_[CurrentIndex()];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex_);
+            queue.tasks_.push_back(std::move(task));
+        }
+        idle_.notify_one();
+    }
+
+    /**
+     * Runs queued tasks (own first, then stolen) until `pending` drops to 0.
+     */
+    void HelpUntilDone(const std::atomic<size_t> &pending)
+    {
+        size_t self = CurrentIndex();
+        while (pending.load(std::memory_order_acquire) != 0)
+        {
+            Task task;
+            if (TryPop(self, task) || TrySteal(self, task))
+            {
+                task();
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    struct Queue
+    {
+        std::mutex mutex_;
+        std::deque<Task> tasks_;
+    };
+
+    static size_t &WorkerIndex()
+    {
+        thread_local size_t index = 0;
+        return index;
+    }
+
+    size_t CurrentIndex() const
+    {
+        return WorkerIndex();
+    }
+
+    bool TryPop(size_t self, Task &task)
+    {
+        Queue &queue = queues_[self];
+        std::lock_guard<std::mutex> lock(queue.mutex_);
+        if (queue.tasks_.empty())
+        {
+            return false;
+        }
+        task = std::move(queue.tasks_.back());
+        queue.tasks_.pop_back();
+        return true;
+    }
+
+    bool TrySteal(size_t self, Task &task)
+    {
+        for (size_t offset = 1; offset < queues_.size(); ++offset)
+        {
+            Queue &queue = queues_[(self + offset) % queues_.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex_);
+            if (!queue.tasks_.empty())
+            {
+                task = std::move(queue.tasks_.front());
+                queue.tasks_.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void WorkerLoop(size_t index)
+    {
+        WorkerIndex() = index;
+        while (!stopping_.load())
+        {
+            Task task;
+            if (TryPop(index, task) || TrySteal(index, task))
+            {
+                task();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(idle_mutex_);
+            idle_.wait_for(lock, std::chrono::milliseconds(1));
+        }
+    }
+
+    std::vector<Queue> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<bool> stopping_{false};
+    std::mutex idle_mutex_;
+    std::condition_variable idle_;
+};
+
+/**
+ * Evaluation settings: the pool to use (or nullptr for serial) and the
+ * smallest subtree worth splitting into tasks.
+ */
+struct EvaluationPolicy
+{
+    WorkStealingPool *pool_ = nullptr;
+    size_t parallel_threshold_ = 10000;
+};
+
+/**
+ * An aggregate says what every node caches: the value of a leaf's label, the
+ * value of an empty branch, and how a child's value folds into its parent's.
+ * Values should be small — a dirty ancestor recombines all of its children's
+ * values, so a re-evaluation after one change costs O(depth x fanout) Combine
+ * calls, and a size or a hash keeps each of them cheap.
+ */
+struct LabelHash
+{
+    using Value = size_t;
+
+    static Value OfLabel(const std::string &label)
+    {
+        return std::hash<std::string>{}(label);
+    }
+    static Value Empty()
+    {
+        return 14695981039346656037ull;
+    }
+    static Value Combine(Value branch, Value child)
+    {
+        return (branch ^ child) * 1099511628211ull;
+    }
+};
+
+struct LabelLength
+{
+    using Value = size_t;
+
+    static Value OfLabel(const std::string &label)
+    {
+        return label.size();
+    }
+    static Value Empty()
+    {
+        return 0;
+    }
+    static Value Combine(Value branch, Value child)
+    {
+        return branch + child;
+    }
+};
+
+/**
+ * The base Component class declares common operations for both simple and
+ * complex objects of a composition. It also owns the cached aggregate.
+ */
+template <typename Aggregate>
+class Component
+{
+public:
+    using Value = typename Aggregate::Value;
+
+protected:
+    Component *parent_ = nullptr;
+    mutable Value result_{};
+    mutable bool dirty_ = true;
+    /**
+     * Number of nodes in this subtree, this one included.
+     */
+    size_t size_ = 1;
+
+    /**
+     * Marks this node and its ancestors dirty. Ancestors of a dirty node are
+     * always dirty too, so the walk stops at the first one that already is.
+     */
+    void Invalidate()
+    {
+        this->dirty_ = true;
+        for (Component *c = this->GetParent(); c != nullptr && !c->dirty_; c = c->GetParent())
+        {
+            c->dirty_ = true;
+        }
+    }
+
+    void Resize(long delta)
+    {
+        for (Component *c = this; c != nullptr; c = c->GetParent())
+        {
+            c->size_ += delta;
+        }
+    }
+
+public:
+    virtual ~Component() {}
+    void SetParent(Component *parent)
+    {
+        this->parent_ = parent;
+    }
+
+    Component *GetParent() const
+    {
+        return this->parent_;
+    }
+
+    virtual void Add(Component *component) {}
+    virtual void Remove(Component *component) {}
+
+    virtual bool IsComposite() const
+    {
+        return false;
+    }
+
+    size_t size() const
+    {
+        return this->size_;
+    }
+
+    bool dirty() const
+    {
+        return this->dirty_;
+    }
+
+    /**
+     * Brings the cached aggregate of this subtree up to date.
+     */
+    virtual void Evaluate(const EvaluationPolicy &policy) const = 0;
+
+    /**
+     * Appends the textual form of this subtree to `out`.
+     */
+    virtual void Render(std::string &out) const = 0;
+
+    /**
+     * The cached aggregate, evaluated serially if it is stale.
+     */
+    const Value &Result() const
+    {
+        if (this->dirty_)
+        {
+            this->Evaluate(EvaluationPolicy{});
+        }
+        return this->result_;
+    }
+
+    /**
+     * The textual form isn't cached: it is built on demand into a single
+     * string, so no node holds a copy of its subtree's text.
+     */
+    std::string Operation() const
+    {
+        std::string result;
+        this->Render(result);
+        return result;
+    }
+
+    /**
+     * Counts recomputed nodes, to show how much work an evaluation did.
+     */
+    static std::atomic<size_t> evaluations_;
+};
+
+template <typename Aggregate>
+std::atomic<size_t> Component<Aggregate>::evaluations_{0};
+
+/**
+ * The Leaf class represents the end objects of a composition. Its label can
+ * change, which invalidates every cached result above it.
+ */
+template <typename Aggregate>
+class Leaf : public Component<Aggregate>
+{
+private:
+    std::string label_;
+
+public:
+    Leaf(std::string label = "Leaf") : label_(std::move(label)) {}
+
+    void SetLabel(std::string label)
+    {
+        this->label_ = std::move(label);
+        this->Invalidate();
+    }
+
+    void Evaluate(const EvaluationPolicy &) const override
+    {
+        if (!this->dirty_)
+        {
+            return;
+        }
+        this->result_ = Aggregate::OfLabel(this->label_);
+        this->dirty_ = false;
+        this->evaluations_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Render(std::string &out) const override
+    {
+        out += this->label_;
+    }
+};
+
+/**
+ * The Composite class represents the complex components that may have children.
+ * Its result is combined from the children's cached results.
+ */
+template <typename Aggregate>
+class Composite : public Component<Aggregate>
+{
+protected:
+    std::vector<Component<Aggregate> *> children_;
+
+public:
+    void Add(Component<Aggregate> *component) override
+    {
+        this->children_.push_back(component);
+        component->SetParent(this);
+        this->Resize(static_cast<long>(component->size()));
+        this->Invalidate();
+    }
+    void Remove(Component<Aggregate> *component) override
+    {
+        auto it = std::find(this->children_.begin(), this->children_.end(), component);
+        if (it == this->children_.end())
+        {
+            return;
+        }
+        this->children_.erase(it);
+        this->Resize(-static_cast<long>(component->size()));
+        component->SetParent(nullptr);
+        this->Invalidate();
+    }
+    bool IsComposite() const override
+    {
+        return true;
+    }
+
+    /**
+     * Dirty children are evaluated first, as pool tasks when this subtree is
+     * large enough, and then their cached values are folded into this one.
+     * Clean children cost one Combine each.
+     */
+    void Evaluate(const EvaluationPolicy &policy) const override
+    {
+        if (!this->dirty_)
+        {
+            return;
+        }
+        if (policy.pool_ != nullptr && this->size_ >= policy.parallel_threshold_ && this->children_.size() > 1)
+        {
+            std::atomic<size_t> pending{0};
+            for (const Component<Aggregate> *c : this->children_)
+            {
+                if (c->dirty())
+                {
+                    pending.fetch_add(1, std::memory_order_relaxed);
+                    policy.pool_->Submit([c, &policy, &pending]
+                                         {
+                        c->Evaluate(policy);
+                        pending.fetch_sub(1, std::memory_order_release); });
+                }
+            }
+            policy.pool_->HelpUntilDone(pending);
+        }
+        else
+        {
+            for (const Component<Aggregate> *c : this->children_)
+            {
+                c->Evaluate(policy);
+            }
+        }
+
+        typename Aggregate::Value value = Aggregate::Empty();
+        for (const Component<Aggregate> *c : this->children_)
+        {
+            value = Aggregate::Combine(value, c->Result());
+        }
+        this->result_ = value;
+        this->dirty_ = false;
+        this->evaluations_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Render(std::string &out) const override
+    {
+        out += "Branch(";
+        for (size_t i = 0; i < this->children_.size(); ++i)
+        {
+            if (i != 0)
+            {
+                out += '+';
+            }
+            this->children_[i]->Render(out);
+        }
+        out += ')';
+    }
+};
+
+/**
+ * The client code works with all of the components via the base interface.
+ */
+template <typename Aggregate>
+void ClientCode(Component<Aggregate> *component)
+{
+    std::cout << "RESULT: " << component->Operation() << " [" << component->Result() << "]";
+}
+
+template <typename Aggregate>
+Component<Aggregate> *Build(int fanout, int depth, std::vector<std::unique_ptr<Component<Aggregate>>> &owned,
+                            std::vector<Leaf<Aggregate> *> &leaves)
+{
+    if (depth == 0)
+    {
+        owned.push_back(std::make_unique<Leaf<Aggregate>>());
+        leaves.push_back(static_cast<Leaf<Aggregate> *>(owned.back().get()));
+        return owned.back().get();
+    }
+    owned.push_back(std::make_unique<Composite<Aggregate>>());
+    Component<Aggregate> *composite = owned.back().get();
+    for (int i = 0; i < fanout; ++i)
+    {
+        composite->Add(Build(fanout, depth - 1, owned, leaves));
+    }
+    return composite;
+}
+
+template <typename F>
+long long Milliseconds(F f)
+{
+    auto begin = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin).count();
+}
+
+int main()
+{
+    Composite<LabelLength> tree;
+    Composite<LabelLength> branch1, branch2;
+    Leaf<LabelLength> leaf_1, leaf_2, leaf_3;
+    branch1.Add(&leaf_1);
+    branch1.Add(&leaf_2);
+    branch2.Add(&leaf_3);
+    tree.Add(&branch1);
+    tree.Add(&branch2);
+    std::cout << "Client: Now I've got a composite tree:\n";
+    ClientCode(&tree);
+    std::cout << "\n\n";
+
+    std::cout << "Client: Renaming one leaf only recomputes its branch and the root:\n";
+    Component<LabelLength>::evaluations_ = 0;
+    leaf_3.SetLabel("Fern");
+    ClientCode(&tree);
+    std::cout << "\n(" << Component<LabelLength>::evaluations_ << " nodes recomputed)\n\n";
+
+    const int fanout = 10, depth = 6;
+    std::vector<std::unique_ptr<Component<LabelHash>>> owned;
+    std::vector<Leaf<LabelHash> *> leaves;
+    Component<LabelHash> *big = Build(fanout, depth, owned, leaves);
+
+    WorkStealingPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    EvaluationPolicy parallel{&pool, 10000};
+
+    long long serial_ms = Milliseconds([&]
+                                       { big->Evaluate(EvaluationPolicy{}); });
+    for (Leaf<LabelHash> *leaf : leaves)
+    {
+        leaf->SetLabel("Leaf");
+    }
+    long long parallel_ms = Milliseconds([&]
+                                         { big->Evaluate(parallel); });
+
+    Component<LabelHash>::evaluations_ = 0;
+    leaves[leaves.size() / 2]->SetLabel("Moss");
+    long long incremental_ms = Milliseconds([&]
+                                            { big->Evaluate(parallel); });
+
+    std::cout << "Client: " << big->size() << " nodes. Full evaluation: serial " << serial_ms << " ms, parallel "
+              << parallel_ms << " ms. After one leaf change: " << Component<LabelHash>::evaluations_ << " nodes recomputed in "
+              << incremental_ms << " ms.\n";
+    return 0;
+}
@@ -0,0 +1,580 @@
+#include <algorithm>
+#include <iostream>
+#include <list>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * Flattened Composite.
+ *
+ * A pointer-based tree of a million nodes spends most of its time chasing
+ * list nodes and concatenating temporary strings. Here the whole tree lives in
+ * one contiguous array in pre-order: a node's subtree is the index range
+ * [i, end), its first child (if any) is i + 1 and its next sibling starts at
+ * the child's end. Traversal is a loop with an explicit stack, and the result
+ * is written into a single buffer whose exact size is known in advance. The
+ * familiar Component interface is still available as a lightweight view.
+ */
+
+/**
+ * The base Component class declares common operations for both simple and
+ * complex objects of a composition.
+ */
+class Component
+{
+    /**
+     * @var Component
+     */
+protected:
+    Component *parent_ = nullptr;
+    /**
+     * Optionally, the base Component can declare an interface for setting and
+     * accessing a parent of the component in a tree structure. It can also
+     * provide some default implementation for these methods.
+     */
+public:
+    virtual ~Component() {}
+    void SetParent(Component *parent)
+    {
+        this->parent_ = parent;
+    }
+
+    Component *GetParent() const
+    {
+        return this->parent_;
+    }
+
+    virtual void Add(Component *component) {}
+    virtual void Remove(Component *component) {}
+
+    /**
+     * You can provide a method that lets the client code figure out whether a
+     * component can bear children.
+     */
+    virtual bool IsComposite() const
+    {
+        return false;
+    }
+
+    virtual std::string Operation() const = 0;
+};
+
+/**
+ * The Leaf class represents the end objects of a composition. A leaf can't have
+ * any children.
+ */
+class Leaf : public Component
+{
+public:
+    std::string Operation() const override
+    {
+        return "Leaf";
+    }
+};
+
+/**
+ * The pointer-based Composite, kept so existing trees can be flattened.
+ */
+class Composite : public Component
+{
+protected:
+    std::list<Component *> children_;
+
+public:
+    void Add(Component *component) override
+    {
+        this->children_.push_back(component);
+        component->SetParent(this);
+    }
+    void Remove(Component *component) override
+    {
+        children_.remove(component);
+        component->SetParent(nullptr);
+    }
+    bool IsComposite() const override
+    {
+        return true;
+    }
+    const std::list<Component *> &children() const
+    {
+        return this->children_;
+    }
+    std::string Operation() const override
+    {
+        std::string result;
+        bool first = true;
+        for (const Component *c : children_)
+        {
+            if (!first)
+            {
+                result += "+";
+            }
+            result += c->Operation();
+            first = false;
+        }
+        return "Branch(" + result + ")";
+    }
+};
+
+class FlatComponent;
+
+/**
+ * The contiguous pre-order tree.
+ */
+class FlatTree
+{
+public:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    enum class Kind : uint8_t
+    {
+        Leaf,
+        Branch
+    };
+
+    struct Node
+    {
+        uint32_t parent_;
+        uint32_t end_;
+        Kind kind_;
+    };
+
+    /**
+     * Building: nodes are appended in pre-order. OpenBranch/CloseBranch
+     * bracket a composite's children.
+     */
+    void Reserve(size_t nodes)
+    {
+        this->nodes_.reserve(nodes);
+    }
+    uint32_t AddLeaf()
+    {
+        uint32_t index = static_cast<uint32_t>(this->nodes_.size());
+        this->nodes_.push_back({this->open_.empty() ? kNone : this->open_.back(), index + 1, Kind::Leaf});
+        return index;
+    }
+    uint32_t OpenBranch()
+    {
+        uint32_t index = static_cast<uint32_t>(this->nodes_.size());
+        this->nodes_.push_back({this->open_.empty() ? kNone : this->open_.back(), index + 1, Kind::Branch});
+        this->open_.push_back(index);
+        return index;
+    }
+    void CloseBranch()
+    {
+        this->nodes_[this->open_.back()].end_ = static_cast<uint32_t>(this->nodes_.size());
+        this->open_.pop_back();
+    }
+
+    /**
+     * Copies a pointer-based tree, iteratively.
+     */
+    static FlatTree From(const Component &root)
+    {
+        FlatTree tree;
+        struct Frame
+        {
+            const Component *component_;
+            bool close_;
+        };
+        std::vector<Frame> stack{{&root, false}};
+        while (!stack.empty())
+        {
+            Frame frame = stack.back();
+            stack.pop_back();
+            if (frame.close_)
+            {
+                tree.CloseBranch();
+                continue;
+            }
+            const Composite *composite = frame.component_->IsComposite() ? dynamic_cast<const Composite *>(frame.component_) : nullptr;
+            if (composite == nullptr)
+            {
+                tree.AddLeaf();
+                continue;
+            }
+            tree.OpenBranch();
+            stack.push_back({nullptr, true});
+            for (auto it = composite->children().rbegin(); it != composite->children().rend(); ++it)
+            {
+                stack.push_back({*it, false});
+            }
+        }
+        return tree;
+    }
+
+    size_t size() const
+    {
+        return this->nodes_.size();
+    }
+    const Node &node(uint32_t index) const
+    {
+        return this->nodes_[index];
+    }
+
+    /**
+     * Exact number of characters Write() produces for the subtree at `index`.
+     */
+    size_t OutputSize(uint32_t index) const
+    {
+        size_t size = 0;
+        for (uint32_t i = index, end = this->nodes_[index].end_; i < end; ++i)
+        {
+            size += this->nodes_[i].kind_ == Kind::Leaf ? 4 : 8;
+            if (i != index && this->nodes_[i].parent_ + 1 != i)
+            {
+                ++size;
+            }
+        }
+        return size;
+    }
+
+    /**
+     * Produces the same text as Composite::Operation() for the subtree at
+     * `index` in one forward pass. `sink(data, size)` receives the pieces.
+     */
+    template <typename Sink>
+    void Emit(uint32_t index, Sink &&sink) const
+    {
+        std::vector<uint32_t> open;
+        uint32_t end = this->nodes_[index].end_;
+        for (uint32_t i = index; i < end; ++i)
+        {
+            while (!open.empty() && open.back() == i)
+            {
+                sink(")", 1);
+                open.pop_back();
+            }
+            const Node &node = this->nodes_[i];
+            if (i != index && node.parent_ + 1 != i)
+            {
+                sink("+", 1);
+            }
+            if (node.kind_ == Kind::Leaf)
+            {
+                sink("Leaf", 4);
+            }
+            else
+            {
+                sink("Branch(", 7);
+                open.push_back(node.end_);
+            }
+        }
+        for (size_t n = open.size(); n > 0; --n)
+        {
+            sink(")", 1);
+        }
+    }
+
+    void Write(uint32_t index, std::string &out) const
+    {
+        out.reserve(out.size() + this->OutputSize(index));
+        this->Emit(index, [&out](const char *data, size_t size)
+                   { out.append(data, size); });
+    }
+
+    /**
+     * Streams through a fixed-size local buffer instead of building a string.
+     */
+    void Write(uint32_t index, std::ostream &os) const
+    {
+        char buffer[16 * 1024];
+        size_t used = 0;
+        this->Emit(index, [&](const char *data, size_t size)
+                   {
+            if (used + size > sizeof(buffer))
+            {
+                os.write(buffer, used);
+                used = 0;
+            }
+            std::copy(data, data + size, buffer + used);
+            used += size; });
+        os.write(buffer, used);
+    }
+
+    /**
+     * Appends a copy of `subtree` as the last child of `parent`. Every index
+     * after the insertion point moves, so this is O(n); use the builder for
+     * bulk construction.
+     */
+    void Insert(uint32_t parent, const FlatTree &subtree)
+    {
+        uint32_t at = this->nodes_[parent].end_;
+        uint32_t count = static_cast<uint32_t>(subtree.size());
+        for (Node &node : this->nodes_)
+        {
+            if (node.end_ >= at && (&node - this->nodes_.data() <= parent || &node - this->nodes_.data() >= at))
+            {
+                node.end_ += count;
+            }
+            if (node.parent_ != kNone && node.parent_ >= at)
+            {
+                node.parent_ += count;
+            }
+        }
+        std::vector<Node> copy(subtree.nodes_);
+        for (Node &node : copy)
+        {
+            node.parent_ = node.parent_ == kNone ? parent : node.parent_ + at;
+            node.end_ += at;
+        }
+        this->nodes_.insert(this->nodes_.begin() + at, copy.begin(), copy.end());
+    }
+
+    /**
+     * Removes the subtree rooted at `index`. O(n) for the same reason.
+     */
+    void Erase(uint32_t index)
+    {
+        uint32_t end = this->nodes_[index].end_;
+        uint32_t count = end - index;
+        this->nodes_.erase(this->nodes_.begin() + index, this->nodes_.begin() + end);
+        for (Node &node : this->nodes_)
+        {
+            if (node.end_ >= end)
+            {
+                node.end_ -= count;
+            }
+            if (node.parent_ != kNone && node.parent_ >= end)
+            {
+                node.parent_ -= count;
+            }
+        }
+    }
+
+    FlatComponent View(uint32_t index);
+
+private:
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> open_;
+};
+
+/**
+ * A Component view of one node of a FlatTree. It is two words wide and is
+ * created on demand, so the tree itself never stores Component objects. The
+ * base class's parent pointer is not used by views; navigate with Parent().
+ */
+class FlatComponent : public Component
+{
+private:
+    FlatTree *tree_;
+    uint32_t index_;
+
+public:
+    FlatComponent(FlatTree *tree, uint32_t index) : tree_(tree), index_(index) {}
+
+    bool IsComposite() const override
+    {
+        return this->tree_->node(this->index_).kind_ == FlatTree::Kind::Branch;
+    }
+
+    /**
+     * Copies `component` (a pointer-based tree or another view) in as the last
+     * child of this node.
+     */
+    void Add(Component *component) override
+    {
+        if (!this->IsComposite())
+        {
+            return;
+        }
+        FlatComponent *view = dynamic_cast<FlatComponent *>(component);
+        if (view != nullptr)
+        {
+            FlatTree subtree;
+            subtree.Reserve(view->tree_->node(view->index_).end_ - view->index_);
+            view->CopyInto(subtree);
+            this->tree_->Insert(this->index_, subtree);
+            return;
+        }
+        this->tree_->Insert(this->index_, FlatTree::From(*component));
+    }
+
+    /**
+     * Only views of this tree's direct children can be removed.
+     */
+    void Remove(Component *component) override
+    {
+        FlatComponent *view = dynamic_cast<FlatComponent *>(component);
+        if (view != nullptr && view->tree_ == this->tree_ && this->tree_->node(view->index_).parent_ == this->index_)
+        {
+            this->tree_->Erase(view->index_);
+        }
+    }
+
+    std::string Operation() const override
+    {
+        std::string result;
+        this->tree_->Write(this->index_, result);
+        return result;
+    }
+
+    void Operation(std::ostream &os) const
+    {
+        this->tree_->Write(this->index_, os);
+    }
+
+    bool HasParent() const
+    {
+        return this->tree_->node(this->index_).parent_ != FlatTree::kNone;
+    }
+    FlatComponent Parent() const
+    {
+        return FlatComponent(this->tree_, this->tree_->node(this->index_).parent_);
+    }
+
+    std::vector<FlatComponent> Children() const
+    {
+        std::vector<FlatComponent> children;
+        for (uint32_t i = this->index_ + 1, end = this->tree_->node(this->index_).end_; i < end; i = this->tree_->node(i).end_)
+        {
+            children.emplace_back(this->tree_, i);
+        }
+        return children;
+    }
+
+private:
+    void CopyInto(FlatTree &out) const
+    {
+        std::vector<uint32_t> open;
+        for (uint32_t i = this->index_, end = this->tree_->node(this->index_).end_; i < end; ++i)
+        {
+            while (!open.empty() && open.back() == i)
+            {
+                out.CloseBranch();
+                open.pop_back();
+            }
+            const FlatTree::Node &node = this->tree_->node(i);
+            if (node.kind_ == FlatTree::Kind::Leaf)
+            {
+                out.AddLeaf();
+            }
+            else
+            {
+                out.OpenBranch();
+                open.push_back(node.end_);
+            }
+        }
+        for (size_t n = open.size(); n > 0; --n)
+        {
+            out.CloseBranch();
+        }
+    }
+};
+
+FlatComponent FlatTree::View(uint32_t index)
+{
+    return FlatComponent(this, index);
+}
+
+/**
+ * The client code works with all of the components via the base interface.
+ */
+void ClientCode(Component *component)
+{
+    std::cout << "RESULT: " << component->Operation();
+}
+
+void ClientCode2(Component *component1, Component *component2)
+{
+    if (component1->IsComposite())
+    {
+        component1->Add(component2);
+    }
+    std::cout << "RESULT: " << component1->Operation();
+}
+
+/**
+ * Builds the same balanced tree both ways: `fanout` children per branch,
+ * `depth` levels of branches above the leaves.
+ */
+void BuildFlat(FlatTree &tree, int fanout, int depth)
+{
+    if (depth == 0)
+    {
+        tree.AddLeaf();
+        return;
+    }
+    tree.OpenBranch();
+    for (int i = 0; i < fanout; ++i)
+    {
+        BuildFlat(tree, fanout, depth - 1);
+    }
+    tree.CloseBranch();
+}
+
+Component *BuildPointers(int fanout, int depth, std::vector<Component *> &owned)
+{
+    Component *component = depth == 0 ? static_cast<Component *>(new Leaf) : new Composite;
+    owned.push_back(component);
+    for (int i = 0; depth > 0 && i < fanout; ++i)
+    {
+        component->Add(BuildPointers(fanout, depth - 1, owned));
+    }
+    return component;
+}
+
+int main()
+{
+    Component *tree = new Composite;
+    Component *branch1 = new Composite;
+    Component *leaf_1 = new Leaf;
+    Component *leaf_2 = new Leaf;
+    Component *leaf_3 = new Leaf;
+    branch1->Add(leaf_1);
+    branch1->Add(leaf_2);
+    Component *branch2 = new Composite;
+    branch2->Add(leaf_3);
+    tree->Add(branch1);
+    tree->Add(branch2);
+
+    FlatTree flat = FlatTree::From(*tree);
+    FlatComponent root = flat.View(0);
+    std::cout << "Client: Now I've got a flattened composite tree:\n";
+    ClientCode(&root);
+    std::cout << "\n\n";
+
+    std::cout << "Client: I don't need to check the components classes even when managing the tree:\n";
+    Leaf simple;
+    ClientCode2(&root, &simple);
+    std::cout << "\n";
+    std::cout << "Client: ...and removing the first branch again:\n";
+    FlatComponent first = root.Children().front();
+    root.Remove(&first);
+    ClientCode(&root);
+    std::cout << "\n\n";
+
+    delete tree;
+    delete branch1;
+    delete branch2;
+    delete leaf_1;
+    delete leaf_2;
+    delete leaf_3;
+
+    const int fanout = 10, depth = 6;
+    std::vector<Component *> owned;
+    Component *pointer_tree = BuildPointers(fanout, depth, owned);
+    FlatTree big;
+    big.Reserve(owned.size());
+    BuildFlat(big, fanout, depth);
+
+    auto begin = std::chrono::steady_clock::now();
+    std::string pointer_result = pointer_tree->Operation();
+    auto pointer_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin);
+    begin = std::chrono::steady_clock::now();
+    std::string flat_result;
+    big.Write(0, flat_result);
+    auto flat_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin);
+
+    std::cout << "Client: " << big.size() << " nodes, " << flat_result.size() << " characters, results "
+              << (pointer_result == flat_result ? "match" : "DIFFER") << ".\n"
+              << "Composite::Operation " << pointer_time.count() << " ms, FlatTree::Write " << flat_time.count() << " ms\n";
+
+    for (Component *component : owned)
+    {
+        delete component;
+    }
+    return 0;
+}
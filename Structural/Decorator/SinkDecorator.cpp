@@ -0,0 +1,295 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <chrono>
+
+/**
+ * Decorators that write into one buffer.
+ *
+ * In Decorator.cpp every decorator returns a new string made of its own text
+ * and the string of the wrapped component, so a chain of depth d allocates d
+ * strings and copies the innermost text d times. Here Operation() appends to
+ * a buffer owned by the caller: a decorator writes its opening part, lets the
+ * wrapped component append its own text, and writes its closing part. The
+ * whole chain fills one buffer, which Length() lets the caller size exactly.
+ *
+ * Decorated<ConcreteComponent, A, B> does the same with the stack fixed at
+ * compile time. The decorators hold what they wrap by value, so the chain is
+ * a single object and its Operation() inlines into a sequence of appends.
+ */
+
+// Counts heap allocations so the benchmark can show where the strings went.
+#include "../../Common/HeapAllocations.h"
+
+/**
+ * The base Component interface defines operations that can be altered by
+ * decorators.
+ */
+class Component {
+public:
+    virtual ~Component() {}
+    /**
+     * Appends this component's result to `out`.
+     */
+    virtual void Operation(std::string &out) const = 0;
+    /**
+     * The number of bytes Operation() appends.
+     */
+    virtual size_t Length() const = 0;
+
+    /**
+     * The result as a string of its own, allocated once and at its final size.
+     */
+    std::string Result() const {
+        std::string out;
+        out.reserve(this->Length());
+        this->Operation(out);
+        return out;
+    }
+};
+
+/**
+ * Concrete Components provide default implementations of the operations. It is
+ * final, so code that knows it has a ConcreteComponent calls it directly.
+ */
+class ConcreteComponent final : public Component {
+public:
+    static constexpr std::string_view kText = "ConcreteComponent";
+
+    void Operation(std::string &out) const override {
+        out.append(kText);
+    }
+    size_t Length() const override {
+        return kText.size();
+    }
+};
+
+/**
+ * The base Decorator class follows the same interface as the other
+ * components. It wraps the component's output in its own opening and closing
+ * text; concrete decorators only say what that text is.
+ */
+class Decorator : public Component {
+protected:
+    Component *component_;
+    std::string_view open_;
+    std::string_view close_;
+public:
+    Decorator(Component *component, std::string_view open, std::string_view close)
+        : component_(component), open_(open), close_(close) {}
+
+    void Operation(std::string &out) const override {
+        out.append(this->open_);
+        this->component_->Operation(out);
+        out.append(this->close_);
+    }
+    size_t Length() const override {
+        return this->open_.size() + this->component_->Length() + this->close_.size();
+    }
+};
+
+class ConcreteDecoratorA : public Decorator {
+public:
+    ConcreteDecoratorA(Component *component) : Decorator(component, "ConcreteDecoratorA(", ")") {}
+};
+
+class ConcreteDecoratorB : public Decorator {
+public:
+    ConcreteDecoratorB(Component *component) : Decorator(component, "ConcreteDecoratorB(", ")") {}
+};
+
+/**
+ * The compile-time decorators. Each one is a template over the type it wraps
+ * and holds it by value.
+ */
+namespace Static {
+template <typename Inner>
+class DecoratorA {
+private:
+    Inner inner_;
+public:
+    void Operation(std::string &out) const {
+        out.append("ConcreteDecoratorA(");
+        this->inner_.Operation(out);
+        out.push_back(')');
+    }
+    size_t Length() const {
+        return sizeof("ConcreteDecoratorA()") - 1 + this->inner_.Length();
+    }
+};
+
+template <typename Inner>
+class DecoratorB {
+private:
+    Inner inner_;
+public:
+    void Operation(std::string &out) const {
+        out.append("ConcreteDecoratorB(");
+        this->inner_.Operation(out);
+        out.push_back(')');
+    }
+    size_t Length() const {
+        return sizeof("ConcreteDecoratorB()") - 1 + this->inner_.Length();
+    }
+};
+}
+
+/**
+ * Applies the decorators to the component in the order they are listed, so
+ * the last one ends up outermost, as with `new B(new A(component))`.
+ */
+template <typename ComponentT, template <typename> class... Decorators>
+struct DecorateAll;
+
+template <typename ComponentT>
+struct DecorateAll<ComponentT> {
+    using type = ComponentT;
+};
+
+template <typename ComponentT, template <typename> class First, template <typename> class... Rest>
+struct DecorateAll<ComponentT, First, Rest...> {
+    using type = typename DecorateAll<First<ComponentT>, Rest...>::type;
+};
+
+template <typename ComponentT, template <typename> class... Decorators>
+using Decorated = typename DecorateAll<ComponentT, Decorators...>::type;
+
+/**
+ * The client code works with all objects using the Component interface. It
+ * keeps one output buffer and reuses it.
+ */
+void ClientCode(const Component &component, std::string &out) {
+    out.clear();
+    component.Operation(out);
+    std::cout << "RESULT: " << out;
+}
+
+/**
+ * Decorator.cpp's decorators, for comparison.
+ */
+class StringComponent {
+public:
+    virtual ~StringComponent() {}
+    virtual std::string Operation() const = 0;
+};
+class StringConcreteComponent : public StringComponent {
+public:
+    std::string Operation() const override {
+        return "ConcreteComponent";
+    }
+};
+class StringDecorator : public StringComponent {
+protected:
+    StringComponent *component_;
+    const char *name_;
+public:
+    StringDecorator(StringComponent *component, const char *name) : component_(component), name_(name) {}
+    std::string Operation() const override {
+        return this->name_ + ("(" + this->component_->Operation() + ")");
+    }
+};
+
+template <typename Run>
+double TimeRuns(size_t runs, size_t &bytes, size_t &allocations, Run run) {
+    size_t before = g_HeapAllocations;
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < runs; ++i) {
+        bytes += run();
+    }
+    auto time = std::chrono::steady_clock::now() - begin;
+    allocations = g_HeapAllocations - before;
+    return std::chrono::duration<double, std::nano>(time).count() / runs;
+}
+
+/**
+ * Sixteen decorators deep, alternating A and B.
+ */
+using Stack16 = Decorated<ConcreteComponent,
+                          Static::DecoratorA, Static::DecoratorB, Static::DecoratorA, Static::DecoratorB,
+                          Static::DecoratorA, Static::DecoratorB, Static::DecoratorA, Static::DecoratorB,
+                          Static::DecoratorA, Static::DecoratorB, Static::DecoratorA, Static::DecoratorB,
+                          Static::DecoratorA, Static::DecoratorB, Static::DecoratorA, Static::DecoratorB>;
+
+void Benchmark() {
+    const size_t depth = 16, runs = 1000000;
+    StringConcreteComponent string_simple;
+    std::vector<std::unique_ptr<StringComponent>> string_chain;
+    ConcreteComponent simple;
+    std::vector<std::unique_ptr<Component>> chain;
+    for (size_t i = 0; i < depth; ++i) {
+        StringComponent *string_inner = i == 0 ? &string_simple : string_chain.back().get();
+        Component *inner = i == 0 ? static_cast<Component *>(&simple) : chain.back().get();
+        if (i % 2 == 0) {
+            string_chain.push_back(std::make_unique<StringDecorator>(string_inner, "ConcreteDecoratorA"));
+            chain.push_back(std::make_unique<ConcreteDecoratorA>(inner));
+        } else {
+            string_chain.push_back(std::make_unique<StringDecorator>(string_inner, "ConcreteDecoratorB"));
+            chain.push_back(std::make_unique<ConcreteDecoratorB>(inner));
+        }
+    }
+    const StringComponent &string_top = *string_chain.back();
+    const Component &top = *chain.back();
+    Stack16 fixed;
+    if (string_top.Operation() != top.Result() || top.Result() != [&] { std::string s; fixed.Operation(s); return s; }()) {
+        std::cout << "the decorator chains disagree\n";
+        return;
+    }
+
+    size_t bytes = 0, string_allocations, sink_allocations, fixed_allocations;
+    double string_ns = TimeRuns(runs, bytes, string_allocations, [&] { return string_top.Operation().size(); });
+    std::string out;
+    out.reserve(top.Length());
+    double sink_ns = TimeRuns(runs, bytes, sink_allocations, [&] {
+        out.clear();
+        top.Operation(out);
+        return out.size();
+    });
+    double fixed_ns = TimeRuns(runs, bytes, fixed_allocations, [&] {
+        out.clear();
+        fixed.Operation(out);
+        return out.size();
+    });
+
+    std::cout << "\n" << runs << " runs of a chain " << depth << " decorators deep (" << bytes << " bytes):\n"
+              << "  new string per decorator:       " << string_ns << " ns per run, "
+              << static_cast<double>(string_allocations) / runs << " allocations per run\n"
+              << "  appending to one buffer:        " << sink_ns << " ns per run, "
+              << static_cast<double>(sink_allocations) / runs << " allocations per run\n"
+              << "  Decorated<...> at compile time: " << fixed_ns << " ns per run, "
+              << static_cast<double>(fixed_allocations) / runs << " allocations per run\n";
+}
+
+int main() {
+    std::string out;
+    /**
+     * This way the client code can support both simple components...
+     */
+    ConcreteComponent simple;
+    std::cout << "Client: I've got a simple component:\n";
+    ClientCode(simple, out);
+    std::cout << "\n\n";
+    /**
+     * ...as well as decorated ones.
+     *
+     * Note how decorators can wrap not only simple components but the other
+     * decorators as well.
+     */
+    ConcreteDecoratorA decorator1(&simple);
+    ConcreteDecoratorB decorator2(&decorator1);
+    std::cout << "Client: Now I've got a decorated component:\n";
+    ClientCode(decorator2, out);
+    std::cout << "\n\n";
+
+    /**
+     * The same stack, fixed at compile time.
+     */
+    Decorated<ConcreteComponent, Static::DecoratorA, Static::DecoratorB> fixed;
+    out.clear();
+    fixed.Operation(out);
+    std::cout << "Client: And one decorated at compile time:\nRESULT: " << out << "\n";
+
+    Benchmark();
+    return 0;
+}
@@ -0,0 +1,271 @@
+/**
+ * A Facade that calls its subsystems concurrently.
+ *
+ * Facade.cpp calls the subsystems one after another, so when each call waits
+ * on a remote service the client waits for the sum of all of them. The
+ * AsyncFacade describes its work as steps, each naming the steps it depends
+ * on. Operation() starts every step at once on its own thread, lets each one
+ * wait only for its own dependencies, and then puts the results together in
+ * one buffer reserved at the final size. The client waits for the longest
+ * chain of dependent steps, and the facade reports how long each step took.
+ */
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <future>
+#include <thread>
+#include <chrono>
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * The subsystems of Facade.cpp, now standing for remote services: every
+ * operation takes a while to answer.
+ */
+class Subsystem1
+{
+private:
+    std::chrono::milliseconds latency_;
+public:
+    explicit Subsystem1(std::chrono::milliseconds latency = std::chrono::milliseconds(20)) : latency_(latency) {}
+
+    std::string Operation1() const
+    {
+        std::this_thread::sleep_for(this->latency_);
+        return "Subsystem1: Ready!\n";
+    }
+    // ...
+    std::string OperationN() const
+    {
+        std::this_thread::sleep_for(this->latency_);
+        return "Subsystem1: Go!\n";
+    }
+};
+
+class Subsystem2
+{
+private:
+    std::chrono::milliseconds latency_;
+public:
+    explicit Subsystem2(std::chrono::milliseconds latency = std::chrono::milliseconds(30)) : latency_(latency) {}
+
+    std::string Operation1() const
+    {
+        std::this_thread::sleep_for(this->latency_);
+        return "Subsystem2: Get ready!\n";
+    }
+    // ...
+    std::string OperationZ() const
+    {
+        std::this_thread::sleep_for(this->latency_);
+        return "Subsystem2: Fire!\n";
+    }
+};
+
+/**
+ * The Facade of Facade.cpp, for comparison.
+ */
+class Facade
+{
+protected:
+    Subsystem1 *subsystem1_;
+    Subsystem2 *subsystem2_;
+public:
+    Facade(Subsystem1 *subsystem1, Subsystem2 *subsystem2) : subsystem1_(subsystem1), subsystem2_(subsystem2) {}
+
+    std::string Operation() {
+        std::string result = "Facade initializes subsystems:\n";
+        result += this->subsystem1_->Operation1();
+        result += this->subsystem2_->Operation1();
+        result += "Facade orders subsystems to perform the action:\n";
+        result += this->subsystem1_->OperationN();
+        result += this->subsystem2_->OperationZ();
+        return result;
+    }
+};
+
+/**
+ * The asynchronous Facade. Its steps are fixed when it is built; Operation()
+ * can be called any number of times.
+ */
+class AsyncFacade
+{
+public:
+    enum class Phase { Init, Action };
+
+    struct Timing {
+        std::string_view step_;
+        double started_ms_;
+        double took_ms_;
+    };
+
+protected:
+    struct Step {
+        std::string_view name_;
+        Phase phase_;
+        std::function<std::string()> run_;
+        std::vector<size_t> after_;
+    };
+
+    Subsystem1 *subsystem1_;
+    Subsystem2 *subsystem2_;
+    std::vector<Step> steps_;
+    std::vector<Timing> timings_;
+
+    /**
+     * Adds a step that starts once the listed steps have finished. A step can
+     * only depend on steps added before it, which rules out cycles; returns
+     * false and adds nothing otherwise.
+     */
+    bool AddStep(std::string_view name, Phase phase, std::function<std::string()> run, std::vector<size_t> after = {}) {
+        for (size_t dependency : after) {
+            if (dependency >= this->steps_.size()) {
+                return false;
+            }
+        }
+        this->steps_.push_back(Step{name, phase, std::move(run), std::move(after)});
+        return true;
+    }
+
+public:
+    /**
+     * Each subsystem has to be initialized before it acts, but the two
+     * subsystems don't wait for each other. A facade whose subsystems did
+     * would list both Init steps for each Action step.
+     */
+    AsyncFacade(Subsystem1 *subsystem1 = nullptr, Subsystem2 *subsystem2 = nullptr)
+    {
+        this->subsystem1_ = subsystem1 ? subsystem1 : new Subsystem1;
+        this->subsystem2_ = subsystem2 ? subsystem2 : new Subsystem2;
+        this->AddStep("Subsystem1::Operation1", Phase::Init, [this] { return this->subsystem1_->Operation1(); });
+        this->AddStep("Subsystem2::Operation1", Phase::Init, [this] { return this->subsystem2_->Operation1(); });
+        this->AddStep("Subsystem1::OperationN", Phase::Action, [this] { return this->subsystem1_->OperationN(); }, {0});
+        this->AddStep("Subsystem2::OperationZ", Phase::Action, [this] { return this->subsystem2_->OperationZ(); }, {1});
+    }
+    ~AsyncFacade()
+    {
+        delete subsystem1_;
+        delete subsystem2_;
+    }
+
+    AsyncFacade(const AsyncFacade &) = delete;
+    AsyncFacade &operator=(const AsyncFacade &) = delete;
+
+    std::string Operation() {
+        std::string result;
+        this->Operation(result);
+        return result;
+    }
+
+    /**
+     * Appends the combined result to `out`, in the same order as the
+     * sequential Facade, whatever order the steps finished in. If a step
+     * throws, the steps after it don't run, nothing is appended and the
+     * exception is rethrown.
+     */
+    void Operation(std::string &out) {
+        static constexpr std::string_view kInitHeader = "Facade initializes subsystems:\n";
+        static constexpr std::string_view kActionHeader = "Facade orders subsystems to perform the action:\n";
+
+        Clock::time_point begin = Clock::now();
+        std::vector<std::string> results(this->steps_.size());
+        std::vector<std::shared_future<void>> done(this->steps_.size());
+        this->timings_.assign(this->steps_.size(), Timing{});
+        for (size_t i = 0; i < this->steps_.size(); ++i) {
+            // A step's dependencies come before it, so their futures already exist
+            std::vector<std::shared_future<void>> after;
+            for (size_t dependency : this->steps_[i].after_) {
+                after.push_back(done[dependency]);
+            }
+            done[i] = std::async(std::launch::async, [this, i, begin, &results, after = std::move(after)] {
+                // A failed dependency rethrows here, so this step fails with it instead of running
+                for (const std::shared_future<void> &dependency : after) {
+                    dependency.get();
+                }
+                Clock::time_point started = Clock::now();
+                results[i] = this->steps_[i].run_();
+                Timing &timing = this->timings_[i];
+                timing.step_ = this->steps_[i].name_;
+                timing.started_ms_ = std::chrono::duration<double, std::milli>(started - begin).count();
+                timing.took_ms_ = std::chrono::duration<double, std::milli>(Clock::now() - started).count();
+            }).share();
+        }
+        // Every step uses `results`, so all of them finish before the first failure is rethrown
+        for (const std::shared_future<void> &step : done) {
+            step.wait();
+        }
+        for (const std::shared_future<void> &step : done) {
+            step.get();
+        }
+
+        size_t size = out.size() + kInitHeader.size() + kActionHeader.size();
+        for (const std::string &result : results) {
+            size += result.size();
+        }
+        out.reserve(size);
+        for (Phase phase : {Phase::Init, Phase::Action}) {
+            out.append(phase == Phase::Init ? kInitHeader : kActionHeader);
+            for (size_t i = 0; i < this->steps_.size(); ++i) {
+                if (this->steps_[i].phase_ == phase) {
+                    out.append(results[i]);
+                }
+            }
+        }
+    }
+
+    /**
+     * When each step of the last Operation() started, counted from the start
+     * of the Operation(), and how long it took.
+     */
+    const std::vector<Timing> &Timings() const {
+        return this->timings_;
+    }
+};
+
+/**
+ * The client code works with complex subsystems through a simple interface
+ * provided by the Facade.
+ */
+void ClientCode(AsyncFacade *facade) {
+    // ...
+    std::cout << facade->Operation();
+    // ...
+}
+
+int main() {
+    Subsystem1 *subsystem1 = new Subsystem1;
+    AsyncFacade *facade = new AsyncFacade(subsystem1);
+    ClientCode(facade);
+    std::cout << "\nSteps of the last operation:\n";
+    for (const AsyncFacade::Timing &timing : facade->Timings()) {
+        std::cout << "  " << timing.step_ << ": started at " << timing.started_ms_ << " ms, took " << timing.took_ms_ << " ms\n";
+    }
+
+    Subsystem1 sequential1;
+    Subsystem2 sequential2;
+    Facade sequential(&sequential1, &sequential2);
+    const size_t runs = 10;
+    bool same = sequential.Operation() == facade->Operation();
+    Clock::time_point begin = Clock::now();
+    for (size_t i = 0; i < runs; ++i) {
+        sequential.Operation();
+    }
+    double sequential_ms = std::chrono::duration<double, std::milli>(Clock::now() - begin).count() / runs;
+    std::string out;
+    begin = Clock::now();
+    for (size_t i = 0; i < runs; ++i) {
+        out.clear();
+        facade->Operation(out);
+    }
+    double async_ms = std::chrono::duration<double, std::milli>(Clock::now() - begin).count() / runs;
+
+    std::cout << "\nOne operation, subsystem calls of 20 ms and 30 ms (same result: " << std::boolalpha << same << "):\n"
+              << "  Facade, one call after another: " << sequential_ms << " ms\n"
+              << "  AsyncFacade, concurrent steps:  " << async_ms << " ms\n";
+
+    delete facade;
+
+    return 0;
+}
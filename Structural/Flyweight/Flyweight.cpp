@@ -118,7 +118,7 @@ public:
     {
         size_t count = this->flyweights_.size();
         std::cout << "\nFlyweightFactory: I have " << count << " flyweights:\n";
-        for (std::pair<std::string, Flyweight> pair : this->flyweights_)
+        for (const std::pair<const std::string, Flyweight> &pair : this->flyweights_)
         {
             std::cout << pair.first << "\n";
         }
@@ -0,0 +1,516 @@
+/**
+ * Flyweight Design Pattern (interned variant)
+ *
+ * Intent: Lets you fit more objects into the available amount of RAM by sharing
+ * common parts of state between multiple objects, instead of keeping all of the
+ * data in each object.
+ *
+ * This variant is meant for millions of records. Every distinct brand, model
+ * and color string is stored once in a StringPool, every distinct combination
+ * of them is stored once as a canonical SharedState, and clients only keep a
+ * 32-bit FlyweightHandle. Lookups hash the three fields directly, so no
+ * temporary key string is ever built.
+ */
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <initializer_list>
+#include <functional>
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+/**
+ * The StringPool keeps a single copy of every distinct string it is given and
+ * identifies it by a dense 32-bit id. A std::deque never moves its elements, so
+ * the string_views handed out (and used as map keys) stay valid for the
+ * lifetime of the pool.
+ */
+class StringPool
+{
+private:
+    std::deque<std::string> strings_;
+    std::unordered_map<std::string_view, uint32_t> ids_;
+    size_t bytes_ = 0;
+
+public:
+    uint32_t Intern(std::string_view s)
+    {
+        auto it = this->ids_.find(s);
+        if (it != this->ids_.end())
+        {
+            return it->second;
+        }
+        uint32_t id = static_cast<uint32_t>(this->strings_.size());
+        const std::string &stored = this->strings_.emplace_back(s);
+        this->ids_.emplace(stored, id);
+        this->bytes_ += sizeof(std::string) + (stored.capacity() > std::string().capacity() ? stored.capacity() + 1 : 0);
+        return id;
+    }
+
+    std::string_view View(uint32_t id) const
+    {
+        return this->strings_[id];
+    }
+
+    size_t size() const
+    {
+        return this->strings_.size();
+    }
+
+    /**
+     * Approximate heap footprint of the pool: the stored strings plus the
+     * id lookup table.
+     */
+    size_t bytes() const
+    {
+        return this->bytes_ + this->ids_.size() * (sizeof(std::string_view) + sizeof(uint32_t) + sizeof(void *)) + this->ids_.bucket_count() * sizeof(void *);
+    }
+};
+
+/**
+ * The canonical intrinsic state. It refers to pooled strings by id, so it is
+ * 12 bytes instead of three std::string objects.
+ */
+struct SharedState
+{
+    uint32_t brand_;
+    uint32_t model_;
+    uint32_t color_;
+};
+
+struct UniqueState
+{
+    std::string owner_;
+    std::string plates_;
+
+    UniqueState(const std::string &owner, const std::string &plates) : owner_(owner), plates_(plates) {}
+
+    friend std::ostream &operator<<(std::ostream &os, const UniqueState &us)
+    {
+        return os << "[ " << us.owner_ << " , " << us.plates_ << " ]";
+    }
+};
+
+/**
+ * A stable handle to one canonical SharedState. It stays valid for as long as
+ * the factory that issued it is alive.
+ */
+using FlyweightHandle = uint32_t;
+
+/**
+ * The Flyweight is now a cheap, non-owning view: copying it copies two
+ * pointers, never the shared state.
+ */
+class Flyweight
+{
+private:
+    const SharedState *shared_state_;
+    const StringPool *pool_;
+
+public:
+    Flyweight(const SharedState *shared_state, const StringPool *pool) : shared_state_(shared_state), pool_(pool) {}
+
+    const SharedState *shared_state() const
+    {
+        return shared_state_;
+    }
+    std::string_view brand() const
+    {
+        return pool_->View(shared_state_->brand_);
+    }
+    std::string_view model() const
+    {
+        return pool_->View(shared_state_->model_);
+    }
+    std::string_view color() const
+    {
+        return pool_->View(shared_state_->color_);
+    }
+    void Operation(const UniqueState &unique_state) const
+    {
+        std::cout << "Flyweight: Displaying shared ([ " << brand() << " , " << model() << " , " << color() << " ]) and unique (" << unique_state << ") state.\n";
+    }
+};
+
+/**
+ * What the same records would cost if every one of them carried its own copy
+ * of the shared state, compared with what the interned factory really uses.
+ */
+struct MemoryReport
+{
+    size_t records_;
+    size_t naive_bytes_;
+    size_t interned_bytes_;
+
+    long long saved() const
+    {
+        return static_cast<long long>(naive_bytes_) - static_cast<long long>(interned_bytes_);
+    }
+
+    friend std::ostream &operator<<(std::ostream &os, const MemoryReport &r)
+    {
+        return os << r.records_ << " records: naive " << r.naive_bytes_ << " B, interned " << r.interned_bytes_
+                  << " B, saved " << r.saved() << " B";
+    }
+};
+
+/**
+ * The Flyweight Factory creates and manages the Flyweight objects. Canonical
+ * states live in a std::deque so references to them are never invalidated, and
+ * the index is an open-addressing table of handles keyed by a hash of the
+ * three field values.
+ */
+class FlyweightFactory
+{
+private:
+    static constexpr uint32_t kEmpty = UINT32_MAX;
+
+    StringPool pool_;
+    std::deque<SharedState> states_;
+    std::vector<size_t> hashes_;
+    std::vector<FlyweightHandle> slots_;
+    size_t records_ = 0;
+    size_t naive_bytes_ = 0;
+
+    /**
+     * Combines the hashes of the three fields without concatenating them.
+     */
+    static size_t Hash(std::string_view brand, std::string_view model, std::string_view color)
+    {
+        std::hash<std::string_view> h;
+        size_t seed = h(brand);
+        seed ^= h(model) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+        seed ^= h(color) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+        return seed;
+    }
+
+    bool Matches(FlyweightHandle handle, std::string_view brand, std::string_view model, std::string_view color) const
+    {
+        const SharedState &ss = this->states_[handle];
+        return this->pool_.View(ss.brand_) == brand && this->pool_.View(ss.model_) == model && this->pool_.View(ss.color_) == color;
+    }
+
+    /**
+     * Returns the slot holding the matching handle, or the empty slot where it
+     * should be inserted.
+     */
+    size_t Probe(size_t hash, std::string_view brand, std::string_view model, std::string_view color) const
+    {
+        size_t mask = this->slots_.size() - 1;
+        for (size_t i = hash & mask;; i = (i + 1) & mask)
+        {
+            FlyweightHandle handle = this->slots_[i];
+            if (handle == kEmpty || (this->hashes_[handle] == hash && this->Matches(handle, brand, model, color)))
+            {
+                return i;
+            }
+        }
+    }
+
+    void Grow()
+    {
+        std::vector<FlyweightHandle> slots(this->slots_.empty() ? 16 : this->slots_.size() * 2, kEmpty);
+        size_t mask = slots.size() - 1;
+        for (FlyweightHandle handle = 0; handle < this->states_.size(); ++handle)
+        {
+            size_t i = this->hashes_[handle] & mask;
+            while (slots[i] != kEmpty)
+            {
+                i = (i + 1) & mask;
+            }
+            slots[i] = handle;
+        }
+        this->slots_.swap(slots);
+    }
+
+    static size_t NaiveStringBytes(std::string_view s)
+    {
+        return sizeof(std::string) + (s.size() > std::string().capacity() ? s.size() + 1 : 0);
+    }
+
+public:
+    struct Key
+    {
+        std::string_view brand_;
+        std::string_view model_;
+        std::string_view color_;
+    };
+
+    FlyweightFactory(std::initializer_list<Key> share_states)
+    {
+        for (const Key &k : share_states)
+        {
+            this->Intern(k.brand_, k.model_, k.color_);
+        }
+    }
+
+    /**
+     * Returns the handle of the canonical state for the given fields, creating
+     * it on first use. This is the hot path: it does not print and it does not
+     * allocate unless the combination is new.
+     */
+    FlyweightHandle Intern(std::string_view brand, std::string_view model, std::string_view color)
+    {
+        if ((this->states_.size() + 1) * 4 > this->slots_.size() * 3)
+        {
+            this->Grow();
+        }
+        size_t hash = Hash(brand, model, color);
+        size_t slot = this->Probe(hash, brand, model, color);
+        if (this->slots_[slot] == kEmpty)
+        {
+            FlyweightHandle handle = static_cast<FlyweightHandle>(this->states_.size());
+            this->states_.push_back({this->pool_.Intern(brand), this->pool_.Intern(model), this->pool_.Intern(color)});
+            this->hashes_.push_back(hash);
+            this->slots_[slot] = handle;
+        }
+        return this->slots_[slot];
+    }
+
+    /**
+     * Same as Intern, but also accounts the request as one client record for
+     * the memory report.
+     */
+    FlyweightHandle Acquire(std::string_view brand, std::string_view model, std::string_view color)
+    {
+        ++this->records_;
+        this->naive_bytes_ += NaiveStringBytes(brand) + NaiveStringBytes(model) + NaiveStringBytes(color);
+        return this->Intern(brand, model, color);
+    }
+
+    /**
+     * Returns an existing Flyweight with a given state or creates a new one.
+     */
+    Flyweight GetFlyweight(std::string_view brand, std::string_view model, std::string_view color)
+    {
+        return this->Get(this->Acquire(brand, model, color));
+    }
+
+    Flyweight Get(FlyweightHandle handle) const
+    {
+        return Flyweight(&this->states_[handle], &this->pool_);
+    }
+
+    const SharedState &state(FlyweightHandle handle) const
+    {
+        return this->states_[handle];
+    }
+
+    const StringPool &pool() const
+    {
+        return this->pool_;
+    }
+
+    size_t size() const
+    {
+        return this->states_.size();
+    }
+
+    /**
+     * Naive layout: one SharedState with three std::string per record.
+     * Interned layout: one handle per record, plus the pool, the canonical
+     * states and the hash index.
+     */
+    MemoryReport Report() const
+    {
+        size_t interned = this->records_ * sizeof(FlyweightHandle) + this->pool_.bytes() + this->states_.size() * (sizeof(SharedState) + sizeof(size_t)) + this->slots_.size() * sizeof(FlyweightHandle);
+        return {this->records_, this->naive_bytes_, interned};
+    }
+
+    void ListFlyweights() const
+    {
+        std::cout << "\nFlyweightFactory: I have " << this->states_.size() << " flyweights:\n";
+        for (FlyweightHandle handle = 0; handle < this->states_.size(); ++handle)
+        {
+            Flyweight flyweight = this->Get(handle);
+            std::cout << flyweight.brand() << "_" << flyweight.model() << "_" << flyweight.color() << "\n";
+        }
+    }
+};
+
+FlyweightHandle AddCarToPoliceDatabase(
+    FlyweightFactory &ff, const std::string &plates, const std::string &owner, const std::string &brand, const std::string &model, const std::string &color)
+{
+    std::cout << "\n\nClient: Adding a car to database.\n";
+    FlyweightHandle handle = ff.Acquire(brand, model, color);
+    // The client code either stores or calculates extrinsic state and passes it to the flyweight's methods.
+    ff.Get(handle).Operation({owner, plates});
+    return handle;
+}
+
+/**
+ * One input row for bulk ingest. The views only need to stay valid for the
+ * duration of the AddCars call.
+ */
+struct CarRow
+{
+    std::string_view plates_;
+    std::string_view owner_;
+    std::string_view brand_;
+    std::string_view model_;
+    std::string_view color_;
+};
+
+/**
+ * Plates are stored as a fixed-width, zero-padded code so the whole column is
+ * one flat array.
+ */
+constexpr size_t kPlateWidth = 8;
+using PlateCode = std::array<char, kPlateWidth>;
+
+/**
+ * The police database keeps the extrinsic state as a struct of arrays: row i
+ * is plates_[i], the owner string at owner_offsets_[i]..owner_offsets_[i + 1]
+ * in the owners_ arena, and the flyweight handle flyweights_[i]. Scans touch
+ * only the columns they need, front to back.
+ */
+class PoliceDatabase
+{
+private:
+    FlyweightFactory &factory_;
+    std::vector<PlateCode> plates_;
+    std::vector<uint32_t> owner_offsets_{0};
+    std::string owners_;
+    std::vector<FlyweightHandle> flyweights_;
+
+public:
+    PoliceDatabase(FlyweightFactory &factory) : factory_(factory) {}
+
+    /**
+     * Ingests a batch of rows in one pass: columns are reserved once, every
+     * row's flyweight is resolved without logging, and the owner names are
+     * appended to the arena. Rows whose plates don't fit in kPlateWidth are
+     * skipped. Returns the number of rows stored.
+     */
+    size_t AddCars(const CarRow *rows, size_t count)
+    {
+        size_t owner_bytes = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            owner_bytes += rows[i].owner_.size();
+        }
+        this->plates_.reserve(this->plates_.size() + count);
+        this->owner_offsets_.reserve(this->owner_offsets_.size() + count);
+        this->flyweights_.reserve(this->flyweights_.size() + count);
+        this->owners_.reserve(this->owners_.size() + owner_bytes);
+
+        size_t stored = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const CarRow &row = rows[i];
+            if (row.plates_.size() > kPlateWidth)
+            {
+                continue;
+            }
+            PlateCode code{};
+            std::memcpy(code.data(), row.plates_.data(), row.plates_.size());
+            this->plates_.push_back(code);
+            this->owners_.append(row.owner_);
+            this->owner_offsets_.push_back(static_cast<uint32_t>(this->owners_.size()));
+            this->flyweights_.push_back(this->factory_.Acquire(row.brand_, row.model_, row.color_));
+            ++stored;
+        }
+        return stored;
+    }
+
+    size_t AddCars(const std::vector<CarRow> &rows)
+    {
+        return this->AddCars(rows.data(), rows.size());
+    }
+
+    size_t size() const
+    {
+        return this->flyweights_.size();
+    }
+
+    std::string_view plates(size_t row) const
+    {
+        const PlateCode &code = this->plates_[row];
+        return std::string_view(code.data(), std::find(code.begin(), code.end(), '\0') - code.begin());
+    }
+
+    std::string_view owner(size_t row) const
+    {
+        return std::string_view(this->owners_).substr(this->owner_offsets_[row], this->owner_offsets_[row + 1] - this->owner_offsets_[row]);
+    }
+
+    Flyweight flyweight(size_t row) const
+    {
+        return this->factory_.Get(this->flyweights_[row]);
+    }
+
+    /**
+     * Returns the rows whose shared state satisfies `predicate`. The predicate
+     * runs once per distinct flyweight; the rows themselves are found with a
+     * single linear pass over the 32-bit handle column.
+     */
+    template <typename Predicate>
+    std::vector<uint32_t> Select(Predicate predicate) const
+    {
+        std::vector<uint8_t> matches(this->factory_.size());
+        for (FlyweightHandle handle = 0; handle < matches.size(); ++handle)
+        {
+            matches[handle] = predicate(this->factory_.Get(handle)) ? 1 : 0;
+        }
+        std::vector<uint32_t> rows;
+        const FlyweightHandle *column = this->flyweights_.data();
+        for (size_t i = 0, n = this->flyweights_.size(); i < n; ++i)
+        {
+            if (matches[column[i]])
+            {
+                rows.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        return rows;
+    }
+};
+
+/**
+ * The client code usually creates a bunch of pre-populated flyweights in the
+ * initialization stage of the application.
+ */
+int main()
+{
+    FlyweightFactory factory({{"Chevrolet", "Camaro2018", "pink"}, {"Mercedes Benz", "C300", "black"}, {"Mercedes Benz", "C500", "red"}, {"BMW", "M5", "red"}, {"BMW", "X6", "white"}});
+    factory.ListFlyweights();
+
+    FlyweightHandle first = AddCarToPoliceDatabase(factory, "CL234IR", "James Doe", "BMW", "M5", "red");
+    FlyweightHandle second = AddCarToPoliceDatabase(factory, "CL234IR", "James Doe", "BMW", "X1", "red");
+    factory.ListFlyweights();
+    std::cout << "\nBoth red BMWs share the color string: " << std::boolalpha
+              << (factory.state(first).color_ == factory.state(second).color_) << "\n";
+
+    std::cout << "\nClient: Loading a fleet of one million cars.\n";
+    const char *brands[] = {"Chevrolet", "Mercedes Benz", "BMW", "Toyota"};
+    const char *models[] = {"Camaro2018", "C300", "C500", "M5", "X6", "Corolla"};
+    const char *colors[] = {"pink", "black", "red", "white", "silver metallic"};
+    for (size_t i = 0; i < 1000000; ++i)
+    {
+        factory.Acquire(brands[i % 4], models[i % 6], colors[i % 5]);
+    }
+    std::cout << "FlyweightFactory: " << factory.size() << " flyweights, " << factory.pool().size() << " pooled strings\n"
+              << factory.Report() << "\n";
+
+    std::cout << "\nClient: Bulk loading the police database.\n";
+    PoliceDatabase database(factory);
+    std::vector<CarRow> batch = {
+        {"CL234IR", "James Doe", "BMW", "M5", "red"},
+        {"AA1111BB", "Jane Roe", "BMW", "X6", "white"},
+        {"KA0042EX", "John Smith", "BMW", "X1", "red"},
+        {"BC7777AA", "Mary Major", "Mercedes Benz", "C500", "red"},
+        {"TOO-LONG-PLATE", "Nobody", "BMW", "M5", "red"},
+    };
+    std::cout << "PoliceDatabase: Stored " << database.AddCars(batch) << " of " << batch.size() << " rows.\n";
+    for (uint32_t row : database.Select([](const Flyweight &f) { return f.brand() == "BMW" && f.color() == "red"; }))
+    {
+        std::cout << "Red BMW: " << database.plates(row) << " owned by " << database.owner(row) << " (" << database.flyweight(row).model() << ")\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,499 @@
+/**
+ * A family of proxies for a slow RealSubject.
+ *
+ * Proxy.cpp builds its RealSubject up front and prints from CheckAccess() and
+ * LogAccess() on every request. The proxies here each take one of those
+ * concerns and can be stacked, since they are all Subjects:
+ *
+ * - LazyProxy builds the real subject on the first request, once, even when
+ *   several threads make that first request together.
+ * - CachingProxy remembers results by argument, for a limited time and up to
+ *   a limited number of entries, dropping the least recently used. With
+ *   coalescing on, concurrent requests for the same argument that miss the
+ *   cache share one call to the real subject.
+ * - ProtectionProxy checks access once per calling thread instead of per
+ *   request, and hands a small record of each request to an AccessLog, whose
+ *   own thread does the formatting and the writing.
+ */
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <exception>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+#include <ctime>
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * The Subject interface declares common operations for both RealSubject and the
+ * Proxy. Here a request has an argument and a result, which is what makes
+ * caching possible.
+ */
+class Subject
+{
+public:
+    virtual ~Subject() {}
+    virtual std::string Request(std::string_view argument) const = 0;
+};
+
+/**
+ * The RealSubject is slow to build and slow to ask. It counts both, so the
+ * demo can show how often the proxies let a request through.
+ */
+class RealSubject : public Subject
+{
+private:
+    std::chrono::microseconds cost_;
+    mutable std::atomic<size_t> requests_{0};
+public:
+    static std::atomic<size_t> s_constructed;
+
+    explicit RealSubject(std::chrono::microseconds cost = std::chrono::microseconds(200)) : cost_(cost) {
+        ++s_constructed;
+        std::this_thread::sleep_for(10 * cost);
+    }
+
+    std::string Request(std::string_view argument) const override {
+        ++this->requests_;
+        std::this_thread::sleep_for(this->cost_);
+        return "RealSubject: Handled " + std::string(argument) + ".";
+    }
+
+    size_t requests() const {
+        return this->requests_;
+    }
+};
+
+std::atomic<size_t> RealSubject::s_constructed{0};
+
+/**
+ * The virtual proxy. It only knows how to make the real subject, and does so
+ * when it's first needed. std::call_once makes the construction happen once;
+ * after that a request is a check of the once flag and a forwarded call.
+ */
+class LazyProxy : public Subject
+{
+private:
+    std::function<std::unique_ptr<Subject>()> factory_;
+    mutable std::once_flag once_;
+    mutable std::unique_ptr<Subject> real_subject_;
+public:
+    explicit LazyProxy(std::function<std::unique_ptr<Subject>()> factory) : factory_(std::move(factory)) {}
+
+    std::string Request(std::string_view argument) const override {
+        return this->Get().Request(argument);
+    }
+
+    const Subject &Get() const {
+        std::call_once(this->once_, [this] { this->real_subject_ = this->factory_(); });
+        return *this->real_subject_;
+    }
+};
+
+struct CacheOptions {
+    size_t capacity_ = 1024;
+    Clock::duration ttl_ = std::chrono::seconds(1);
+    bool coalesce_ = true;
+};
+
+struct CacheStats {
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+    size_t coalesced_ = 0;
+    size_t expired_ = 0;
+    size_t evicted_ = 0;
+};
+
+/**
+ * The caching proxy. Entries sit in a list ordered from most to least recently
+ * used, with an index from argument to list node; the index keys are views of
+ * the strings in the nodes, which never move. The lock is only held to look
+ * up and update the cache, never while the real subject works.
+ */
+class CachingProxy : public Subject
+{
+private:
+    struct Entry {
+        std::string argument_;
+        std::string result_;
+        Clock::time_point expires_;
+    };
+
+    /**
+     * A call to the real subject that other requests can wait for.
+     */
+    struct InFlight {
+        std::string argument_;
+        std::promise<std::string> promise_;
+        std::shared_future<std::string> result_;
+    };
+
+    const Subject &real_subject_;
+    CacheOptions options_;
+    mutable std::mutex mutex_;
+    mutable std::list<Entry> entries_;
+    mutable std::unordered_map<std::string_view, std::list<Entry>::iterator> index_;
+    mutable std::unordered_map<std::string_view, std::shared_ptr<InFlight>> in_flight_;
+    mutable CacheStats stats_;
+
+public:
+    CachingProxy(const Subject &real_subject, CacheOptions options = CacheOptions())
+        : real_subject_(real_subject), options_(options) {}
+
+    std::string Request(std::string_view argument) const override {
+        std::unique_lock<std::mutex> lock(this->mutex_);
+        Clock::time_point now = Clock::now();
+        auto found = this->index_.find(argument);
+        if (found != this->index_.end()) {
+            std::list<Entry>::iterator entry = found->second;
+            if (entry->expires_ > now) {
+                ++this->stats_.hits_;
+                this->entries_.splice(this->entries_.begin(), this->entries_, entry);
+                return entry->result_;
+            }
+            ++this->stats_.expired_;
+            this->index_.erase(found);
+            this->entries_.erase(entry);
+        }
+
+        if (this->options_.coalesce_) {
+            auto pending = this->in_flight_.find(argument);
+            if (pending != this->in_flight_.end()) {
+                ++this->stats_.coalesced_;
+                std::shared_ptr<InFlight> flight = pending->second;
+                lock.unlock();
+                return flight->result_.get();
+            }
+        }
+
+        ++this->stats_.misses_;
+        std::shared_ptr<InFlight> flight;
+        if (this->options_.coalesce_) {
+            flight = std::make_shared<InFlight>();
+            flight->argument_ = std::string(argument);
+            flight->result_ = flight->promise_.get_future().share();
+            this->in_flight_.emplace(flight->argument_, flight);
+        }
+        lock.unlock();
+
+        std::string result;
+        try {
+            result = this->real_subject_.Request(argument);
+        } catch (...) {
+            // Nothing is cached; the waiters get the same exception and the
+            // next request for this argument tries again
+            if (flight) {
+                lock.lock();
+                this->in_flight_.erase(flight->argument_);
+                lock.unlock();
+                flight->promise_.set_exception(std::current_exception());
+            }
+            throw;
+        }
+
+        lock.lock();
+        this->Insert(argument, result, Clock::now() + this->options_.ttl_);
+        if (flight) {
+            this->in_flight_.erase(flight->argument_);
+        }
+        lock.unlock();
+        if (flight) {
+            flight->promise_.set_value(result);
+        }
+        return result;
+    }
+
+    CacheStats Stats() const {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        return this->stats_;
+    }
+
+private:
+    /**
+     * Adds or replaces an entry; the caller holds the lock. Without coalescing
+     * two requests may both have missed and both insert the same argument.
+     */
+    void Insert(std::string_view argument, const std::string &result, Clock::time_point expires) const {
+        auto found = this->index_.find(argument);
+        if (found != this->index_.end()) {
+            std::list<Entry>::iterator entry = found->second;
+            entry->result_ = result;
+            entry->expires_ = expires;
+            this->entries_.splice(this->entries_.begin(), this->entries_, entry);
+            return;
+        }
+        if (this->options_.capacity_ == 0) {
+            return;
+        }
+        if (this->entries_.size() >= this->options_.capacity_) {
+            ++this->stats_.evicted_;
+            this->index_.erase(this->entries_.back().argument_);
+            this->entries_.pop_back();
+        }
+        this->entries_.push_front(Entry{std::string(argument), result, expires});
+        this->index_.emplace(this->entries_.front().argument_, this->entries_.begin());
+    }
+};
+
+/**
+ * Collects access records and writes them out from a thread of its own. A
+ * request only copies a fixed-size record into a buffer under a short lock;
+ * the formatting and the stream happen later, in batches.
+ */
+class AccessLog
+{
+public:
+    struct Record {
+        Clock::time_point at_;
+        std::thread::id caller_;
+        uint32_t nanoseconds_;
+        bool allowed_;
+        char argument_[32];
+    };
+
+    explicit AccessLog(std::ostream &out, std::chrono::milliseconds interval = std::chrono::milliseconds(50))
+        : out_(out), interval_(interval), writer_([this] { this->WriteLoop(); }) {}
+
+    ~AccessLog() {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex_);
+            this->stopping_ = true;
+        }
+        this->wake_.notify_one();
+        this->writer_.join();
+    }
+
+    void Add(std::string_view argument, bool allowed, Clock::time_point begin, Clock::time_point end) {
+        Record record;
+        record.at_ = end;
+        record.caller_ = std::this_thread::get_id();
+        record.nanoseconds_ = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+        record.allowed_ = allowed;
+        size_t length = std::min(argument.size(), sizeof(record.argument_) - 1);
+        std::memcpy(record.argument_, argument.data(), length);
+        record.argument_[length] = '\0';
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        this->pending_.push_back(record);
+    }
+
+    size_t written() const {
+        return this->written_;
+    }
+
+private:
+    void WriteLoop() {
+        std::vector<Record> batch;
+        std::unique_lock<std::mutex> lock(this->mutex_);
+        for (;;) {
+            this->wake_.wait_for(lock, this->interval_, [this] { return this->stopping_; });
+            batch.swap(this->pending_);
+            bool stopping = this->stopping_;
+            lock.unlock();
+            for (const Record &record : batch) {
+                this->out_ << "Proxy: " << (record.allowed_ ? "Served " : "Denied ") << record.argument_ << " for thread "
+                           << record.caller_ << " in " << record.nanoseconds_ << " ns.\n";
+            }
+            this->written_ += batch.size();
+            batch.clear();
+            if (stopping) {
+                return;
+            }
+            lock.lock();
+        }
+    }
+
+    std::ostream &out_;
+    std::chrono::milliseconds interval_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::vector<Record> pending_;
+    bool stopping_ = false;
+    std::atomic<size_t> written_{0};
+    std::thread writer_;
+};
+
+/**
+ * The protection proxy. The access policy may be expensive, so each thread
+ * remembers its answer. Revoke() gives the proxy a new generation number,
+ * which makes every thread ask the policy again.
+ */
+class ProtectionProxy : public Subject
+{
+private:
+    const Subject &subject_;
+    std::function<bool(std::thread::id)> policy_;
+    AccessLog *log_;
+    std::atomic<uint64_t> generation_;
+
+    static std::atomic<uint64_t> s_generations;
+
+    /**
+     * One remembered answer per thread, for the proxy it last used.
+     */
+    struct AccessCache {
+        const ProtectionProxy *proxy_ = nullptr;
+        uint64_t generation_ = 0;
+        bool allowed_ = false;
+    };
+
+    bool CheckAccess() const {
+        static thread_local AccessCache cache;
+        uint64_t generation = this->generation_.load(std::memory_order_acquire);
+        if (cache.proxy_ != this || cache.generation_ != generation) {
+            cache.allowed_ = this->policy_(std::this_thread::get_id());
+            cache.proxy_ = this;
+            cache.generation_ = generation;
+        }
+        return cache.allowed_;
+    }
+
+public:
+    ProtectionProxy(const Subject &subject, std::function<bool(std::thread::id)> policy, AccessLog *log = nullptr)
+        : subject_(subject), policy_(std::move(policy)), log_(log), generation_(++s_generations) {}
+
+    /**
+     * Generation numbers come from one counter for all proxies, so a new proxy
+     * at the address of an old one can't match a stale answer.
+     */
+    void Revoke() {
+        this->generation_.store(++s_generations, std::memory_order_release);
+    }
+
+    std::string Request(std::string_view argument) const override {
+        Clock::time_point begin = Clock::now();
+        bool allowed = this->CheckAccess();
+        std::string result = allowed ? this->subject_.Request(argument) : std::string();
+        if (this->log_ != nullptr) {
+            this->log_->Add(argument, allowed, begin, Clock::now());
+        }
+        return result;
+    }
+};
+
+std::atomic<uint64_t> ProtectionProxy::s_generations{0};
+
+void ClientCode(const Subject &subject) {
+    // ...
+    std::cout << subject.Request("report") << "\n";
+    // ...
+}
+
+/**
+ * Many threads asking for the same few arguments at once.
+ */
+double Burst(const Subject &subject, size_t threads, size_t requests, size_t arguments) {
+    Clock::time_point begin = Clock::now();
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&subject, t, requests, arguments] {
+            for (size_t i = 0; i < requests; ++i) {
+                subject.Request("item" + std::to_string((i * 7 + t) % arguments));
+            }
+        });
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+}
+
+/**
+ * A subject that answers at once, to see what the proxy itself costs.
+ */
+class EchoSubject : public Subject
+{
+public:
+    std::string Request(std::string_view argument) const override {
+        return std::string(argument);
+    }
+};
+
+/**
+ * CPU time the calling thread spends per call, which leaves out what the log
+ * writer does on its own thread.
+ */
+template <typename Call>
+double CallerNanoseconds(size_t calls, Call call) {
+    timespec begin, end;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &begin);
+    for (size_t i = 0; i < calls; ++i) {
+        call();
+    }
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+    return ((end.tv_sec - begin.tv_sec) * 1e9 + (end.tv_nsec - begin.tv_nsec)) / calls;
+}
+
+int main() {
+    std::cout << "Client: Executing the client code with a stack of proxies:\n";
+    LazyProxy lazy([] { return std::make_unique<RealSubject>(); });
+    std::cout << "Real subjects built before the first request: " << RealSubject::s_constructed << "\n";
+    CachingProxy cache(lazy);
+    std::ostringstream log_text;
+    {
+        AccessLog log(log_text);
+        ProtectionProxy proxy(cache, [](std::thread::id) { return true; }, &log);
+        ClientCode(proxy);
+        ClientCode(proxy);
+        std::cout << "Real subjects built: " << RealSubject::s_constructed << ", requests that reached it: "
+                  << static_cast<const RealSubject &>(lazy.Get()).requests() << "\n";
+    }
+    std::cout << "Access log, written in the background:\n" << log_text.str();
+
+    const size_t threads = 8, requests = 200, arguments = 20;
+    std::cout << "\n" << threads << " threads x " << requests << " requests over " << arguments
+              << " arguments, 200 us per real request:\n";
+    for (bool coalesce : {false, true}) {
+        RealSubject real;
+        CacheOptions options;
+        options.capacity_ = 16;
+        options.coalesce_ = coalesce;
+        CachingProxy caching(real, options);
+        double ms = Burst(caching, threads, requests, arguments);
+        CacheStats stats = caching.Stats();
+        std::cout << "  cache of 16, " << (coalesce ? "coalescing:    " : "no coalescing: ") << ms << " ms, "
+                  << real.requests() << " real requests, " << stats.hits_ << " hits, " << stats.coalesced_
+                  << " coalesced, " << stats.evicted_ << " evicted\n";
+    }
+
+    EchoSubject echo;
+    const size_t calls = 1000000;
+    std::ostringstream sink;
+    size_t checks = 0;
+    auto policy = [&checks](std::thread::id) {
+        ++checks;
+        return true;
+    };
+    // Proxy.cpp's way, with the console replaced by a string stream
+    double inline_ns = CallerNanoseconds(calls, [&] {
+        if (policy(std::this_thread::get_id())) {
+            std::string result = echo.Request("item");
+            sink << "Proxy: Served " << result << " for thread " << std::this_thread::get_id() << ".\n";
+        }
+    });
+    size_t inline_checks = checks;
+    checks = 0;
+    double proxy_ns;
+    {
+        std::ostringstream background;
+        AccessLog log(background);
+        ProtectionProxy proxy(echo, policy, &log);
+        proxy_ns = CallerNanoseconds(calls, [&] { proxy.Request("item"); });
+    }
+    std::cout << "\n" << calls << " requests through a protection proxy, CPU time of the calling thread:\n"
+              << "  check and log on every request: " << inline_ns << " ns per request, " << inline_checks << " checks\n"
+              << "  cached check, background log:   " << proxy_ns << " ns per request, " << checks << " checks\n";
+    return 0;
+}